@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Allocation accounting. src/alloc_counter.cpp replaces the global operator new/delete family with malloc/free based
+// versions that count every heap allocation made through them per thread.
+
+struct alloc_counts
+{
+   uint64_t allocations{};
+   uint64_t deallocations{};
+   uint64_t bytes{}; // bytes requested from operator new
+
+   alloc_counts operator-(const alloc_counts& rhs) const
+   {
+      return {allocations - rhs.allocations, deallocations - rhs.deallocations, bytes - rhs.bytes};
+   }
+};
+
+inline thread_local alloc_counts thread_alloc_counts{};
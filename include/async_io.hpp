@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup)
+#define BINARY_PERF_IO_URING
+#endif
+#endif
+
+// Asynchronous file reads and writes on a fixed set of buffers, for the pipeline benchmark. Both engines have the same
+// interface: submit() queues a request and wait() blocks until one request has completed. Only one thread may use an
+// engine. uring_engine drives io_uring through its system calls (no liburing) and registers the buffers once, so the
+// kernel does not pin their pages for every request. thread_pool_engine runs pwrite/pread on worker threads. It is the
+// fallback where io_uring is not compiled in or the kernel refuses it, which seccomp filters in containers often do.
+
+namespace async_io
+{
+   // Blocking multi-producer, multi-consumer queue. pop() returns nothing once the queue is closed and drained.
+   template <class T>
+   class channel
+   {
+     public:
+      void push(T value)
+      {
+         {
+            std::lock_guard lock{mutex};
+            items.push_back(std::move(value));
+         }
+         ready.notify_one();
+      }
+
+      std::optional<T> pop()
+      {
+         std::unique_lock lock{mutex};
+         ready.wait(lock, [&] { return !items.empty() || closed; });
+         return take();
+      }
+
+      std::optional<T> try_pop()
+      {
+         std::lock_guard lock{mutex};
+         return take();
+      }
+
+      void close()
+      {
+         {
+            std::lock_guard lock{mutex};
+            closed = true;
+         }
+         ready.notify_all();
+      }
+
+     private:
+      std::optional<T> take()
+      {
+         if (items.empty()) {
+            return std::nullopt;
+         }
+         auto value = std::move(items.front());
+         items.pop_front();
+         return value;
+      }
+
+      std::mutex mutex{};
+      std::condition_variable ready{};
+      std::deque<T> items{};
+      bool closed = false;
+   };
+
+   enum struct op : uint8_t { write, read };
+
+   struct request
+   {
+      op kind{};
+      uint32_t buffer{}; // index into the engine's buffers; the transfer starts at the beginning of the buffer
+      uint32_t length{};
+      uint64_t offset{}; // file offset
+      uint64_t tag{}; // returned with the completion
+   };
+
+   struct completion
+   {
+      uint64_t tag{};
+      int64_t result{}; // bytes transferred, or -errno
+   };
+
+   class thread_pool_engine
+   {
+     public:
+      static constexpr std::string_view name = "thread pool pwrite/pread";
+
+      thread_pool_engine(int fd, std::span<const iovec> buffers, size_t threads = 4)
+         : fd(fd), buffers(buffers.begin(), buffers.end())
+      {
+         for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this] {
+               while (const auto r = jobs.pop()) {
+                  done.push(run(*r));
+               }
+            });
+         }
+      }
+
+      thread_pool_engine(const thread_pool_engine&) = delete;
+      thread_pool_engine& operator=(const thread_pool_engine&) = delete;
+
+      ~thread_pool_engine()
+      {
+         jobs.close();
+         for (auto& t : workers) {
+            t.join();
+         }
+      }
+
+      bool ok() const { return true; }
+      void submit(const request& r) { jobs.push(r); }
+      completion wait() { return *done.pop(); }
+
+     private:
+      completion run(const request& r) const
+      {
+         auto* data = static_cast<char*>(buffers[r.buffer].iov_base);
+         size_t transferred = 0;
+         while (transferred < r.length) {
+            const auto n = r.kind == op::write
+                              ? ::pwrite(fd, data + transferred, r.length - transferred, off_t(r.offset + transferred))
+                              : ::pread(fd, data + transferred, r.length - transferred, off_t(r.offset + transferred));
+            if (n < 0 && errno == EINTR) {
+               continue;
+            }
+            if (n < 0) {
+               return {r.tag, -int64_t(errno)};
+            }
+            if (n == 0) {
+               break; // end of file
+            }
+            transferred += size_t(n);
+         }
+         return {r.tag, int64_t(transferred)};
+      }
+
+      int fd{};
+      std::vector<iovec> buffers{};
+      channel<request> jobs{};
+      channel<completion> done{};
+      std::vector<std::thread> workers{};
+   };
+
+#ifdef BINARY_PERF_IO_URING
+   class uring_engine
+   {
+     public:
+      static constexpr std::string_view name = "io_uring";
+
+      // entries must be at least the number of requests in flight at once
+      uring_engine(int fd, std::span<const iovec> buffers, unsigned entries)
+         : fd(fd), buffers(buffers.begin(), buffers.end())
+      {
+         io_uring_params p{};
+         ring_fd = int(::syscall(__NR_io_uring_setup, entries, &p));
+         if (ring_fd < 0) {
+            return;
+         }
+         sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+         cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+         const bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+         if (single_mmap) {
+            sq_size = cq_size = (std::max)(sq_size, cq_size);
+         }
+         sq_ring = map(sq_size, IORING_OFF_SQ_RING);
+         cq_ring = single_mmap ? sq_ring : map(cq_size, IORING_OFF_CQ_RING);
+         sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+         sqes = static_cast<io_uring_sqe*>(map(sqes_size, IORING_OFF_SQES));
+         if (!sq_ring || !cq_ring || !sqes) {
+            return;
+         }
+
+         auto* sq = static_cast<char*>(sq_ring);
+         sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+         sq_mask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+         sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+         auto* cq = static_cast<char*>(cq_ring);
+         cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+         cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+         cq_mask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+         cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+         // Registration counts against RLIMIT_MEMLOCK; without it requests use plain READ/WRITE on the same buffers
+         fixed = ::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, this->buffers.data(),
+                           unsigned(this->buffers.size())) == 0;
+         valid = true;
+      }
+
+      uring_engine(const uring_engine&) = delete;
+      uring_engine& operator=(const uring_engine&) = delete;
+
+      ~uring_engine()
+      {
+         if (sqes) {
+            ::munmap(sqes, sqes_size);
+         }
+         if (cq_ring && cq_ring != sq_ring) {
+            ::munmap(cq_ring, cq_size);
+         }
+         if (sq_ring) {
+            ::munmap(sq_ring, sq_size);
+         }
+         if (ring_fd >= 0) {
+            ::close(ring_fd);
+         }
+      }
+
+      bool ok() const { return valid; }
+      bool registered() const { return fixed; }
+
+      // The submission is passed to the kernel by the next wait()
+      void submit(const request& r)
+      {
+         const auto tail = *sq_tail; // only this thread writes the tail
+         const auto index = tail & sq_mask;
+         auto& sqe = sqes[index];
+         std::memset(&sqe, 0, sizeof(sqe));
+         if (r.kind == op::write) {
+            sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+         }
+         else {
+            sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+         }
+         sqe.fd = fd;
+         sqe.addr = reinterpret_cast<uint64_t>(buffers[r.buffer].iov_base);
+         sqe.len = r.length;
+         sqe.off = r.offset;
+         sqe.buf_index = fixed ? uint16_t(r.buffer) : 0;
+         sqe.user_data = r.tag;
+         sq_array[index] = index;
+         std::atomic_ref{*sq_tail}.store(tail + 1, std::memory_order_release);
+         ++unsubmitted;
+      }
+
+      completion wait()
+      {
+         while (true) {
+            const auto head = *cq_head; // only this thread writes the head
+            if (head != std::atomic_ref{*cq_tail}.load(std::memory_order_acquire)) {
+               const auto& cqe = cqes[head & cq_mask];
+               const completion c{cqe.user_data, cqe.res};
+               std::atomic_ref{*cq_head}.store(head + 1, std::memory_order_release);
+               return c;
+            }
+            const auto n =
+               ::syscall(__NR_io_uring_enter, ring_fd, unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, size_t(0));
+            if (n < 0 && errno != EINTR) {
+               return {~uint64_t(0), -int64_t(errno)};
+            }
+            if (n > 0) {
+               unsubmitted -= unsigned(n);
+            }
+         }
+      }
+
+     private:
+      void* map(size_t size, uint64_t offset) const
+      {
+         void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, off_t(offset));
+         return p == MAP_FAILED ? nullptr : p;
+      }
+
+      int fd{};
+      std::vector<iovec> buffers{};
+      int ring_fd = -1;
+      void* sq_ring{};
+      void* cq_ring{};
+      io_uring_sqe* sqes{};
+      size_t sq_size{};
+      size_t cq_size{};
+      size_t sqes_size{};
+      unsigned* sq_tail{};
+      unsigned sq_mask{};
+      unsigned* sq_array{};
+      unsigned* cq_head{};
+      unsigned* cq_tail{};
+      unsigned cq_mask{};
+      io_uring_cqe* cqes{};
+      unsigned unsubmitted{};
+      bool fixed = false;
+      bool valid = false;
+   };
+#endif
+}
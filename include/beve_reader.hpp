@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+#include <type_traits>
+
+// Minimal forward-only BEVE reader (https://github.com/beve-org/beve) used for zero-copy views, field skipping and
+// structural validation. It reads what Glaze writes; it is not a general BEVE implementation.
+
+namespace beve
+{
+   // Low three bits of every header byte
+   enum struct type : uint8_t {
+      null_or_bool = 0,
+      number = 1,
+      string = 2,
+      object = 3,
+      typed_array = 4,
+      array = 5,
+      extension = 6
+   };
+
+   // Bits 3-4 of number and typed array headers
+   enum struct number_kind : uint8_t { floating = 0, signed_int = 1, unsigned_int = 2, bool_or_string = 3 };
+
+   constexpr type header_type(uint8_t header) { return type(header & 0b111); }
+   constexpr number_kind header_kind(uint8_t header) { return number_kind((header >> 3) & 0b11); }
+   // Objects use bits 3-4 for the key type, 0 being string keys
+   constexpr bool string_keys(uint8_t header) { return ((header >> 3) & 0b11) == 0; }
+   // Bits 5-7 encode the element width as a power of two: 1, 2, 4, 8, ... bytes
+   constexpr size_t header_width(uint8_t header) { return size_t(1) << ((header >> 5) & 0b111); }
+
+   // A typed array left in the buffer: count elements of `width` bytes starting at `data` (no alignment guarantee)
+   struct typed_array_view
+   {
+      uint8_t header{};
+      size_t count{};
+      const char* data{};
+
+      template <class T>
+      T get(size_t i) const
+      {
+         T value;
+         std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+         return value;
+      }
+   };
+
+   struct cursor
+   {
+      const char* it{};
+      const char* end{};
+      bool ok = true;
+
+      cursor() = default;
+      cursor(const char* data, size_t size) : it(data), end(data + size) {}
+      explicit cursor(std::string_view buffer) : cursor(buffer.data(), buffer.size()) {}
+
+      bool fail()
+      {
+         ok = false;
+         it = end;
+         return false;
+      }
+
+      bool has(size_t n) const { return size_t(end - it) >= n; }
+
+      uint8_t peek() const { return it < end ? uint8_t(*it) : 0; }
+
+      uint8_t header()
+      {
+         if (!has(1)) {
+            fail();
+            return 0;
+         }
+         return uint8_t(*it++);
+      }
+
+      // Compressed unsigned integer: the two low bits of the first byte select a 1, 2, 4 or 8 byte encoding
+      size_t compressed()
+      {
+         if (!has(1)) {
+            fail();
+            return 0;
+         }
+         const auto bytes = size_t(1) << (uint8_t(*it) & 0b11);
+         if (!has(bytes)) {
+            fail();
+            return 0;
+         }
+         uint64_t value{};
+         std::memcpy(&value, it, bytes); // little endian
+         it += bytes;
+         return size_t(value >> 2);
+      }
+
+      std::string_view bytes(size_t n)
+      {
+         if (!has(n)) {
+            fail();
+            return {};
+         }
+         const std::string_view view{it, n};
+         it += n;
+         return view;
+      }
+
+      // String body after its header (also the layout of object keys)
+      std::string_view string_body() { return bytes(compressed()); }
+
+      std::string_view string()
+      {
+         if (header_type(header()) != type::string) {
+            fail();
+            return {};
+         }
+         return string_body();
+      }
+
+      bool boolean()
+      {
+         const auto h = header();
+         if (header_type(h) != type::null_or_bool || !(h & 0b1000)) {
+            fail();
+            return false;
+         }
+         return (h >> 4) & 1;
+      }
+
+      template <class T>
+      T number_body(uint8_t h)
+      {
+         const auto width = header_width(h);
+         if (!has(width) || width > 8) {
+            fail();
+            return T{};
+         }
+         T value{};
+         switch (header_kind(h)) {
+         case number_kind::floating:
+            if (width == 8) {
+               double d;
+               std::memcpy(&d, it, 8);
+               value = T(d);
+            }
+            else if (width == 4) {
+               float f;
+               std::memcpy(&f, it, 4);
+               value = T(f);
+            }
+            else {
+               fail();
+            }
+            break;
+         case number_kind::signed_int: {
+            int64_t i{};
+            std::memcpy(&i, it, width);
+            const auto shift = 64 - 8 * width; // sign extend
+            value = T(shift ? (i << shift) >> shift : i);
+            break;
+         }
+         case number_kind::unsigned_int: {
+            uint64_t u{};
+            std::memcpy(&u, it, width);
+            value = T(u);
+            break;
+         }
+         default:
+            fail();
+         }
+         it += width;
+         return value;
+      }
+
+      template <class T>
+      T number()
+      {
+         const auto h = header();
+         if (header_type(h) != type::number) {
+            fail();
+            return T{};
+         }
+         return number_body<T>(h);
+      }
+
+      typed_array_view typed_array()
+      {
+         const auto h = header();
+         if (header_type(h) != type::typed_array || header_kind(h) == number_kind::bool_or_string) {
+            fail();
+            return {};
+         }
+         const auto count = compressed();
+         const auto width = header_width(h);
+         if (width && count > size_t(end - it) / width) {
+            fail();
+            return {};
+         }
+         typed_array_view view{h, count, it};
+         it += count * width;
+         return view;
+      }
+
+      // Object header: returns the number of key/value pairs; keys must be strings
+      size_t object()
+      {
+         const auto h = header();
+         if (header_type(h) != type::object || !string_keys(h)) {
+            fail();
+            return 0;
+         }
+         return compressed();
+      }
+
+      std::string_view key() { return string_body(); }
+
+      // Generic array header: returns the element count
+      size_t array()
+      {
+         if (header_type(header()) != type::array) {
+            fail();
+            return 0;
+         }
+         return compressed();
+      }
+
+      // Skips one complete value. Returns false on malformed or truncated input.
+      bool skip(size_t depth = 0)
+      {
+         if (depth > 512) {
+            return fail();
+         }
+         const auto h = header();
+         if (!ok) {
+            return false;
+         }
+         switch (header_type(h)) {
+         case type::null_or_bool:
+            return true;
+         case type::number:
+            bytes(header_width(h));
+            return ok;
+         case type::string:
+            string_body();
+            return ok;
+         case type::object: {
+            const auto n = compressed();
+            for (size_t i = 0; i < n && ok; ++i) {
+               if (string_keys(h)) {
+                  string_body();
+               }
+               else {
+                  bytes(header_width(h));
+               }
+               skip(depth + 1);
+            }
+            return ok;
+         }
+         case type::typed_array: {
+            const auto n = compressed();
+            if (header_kind(h) != number_kind::bool_or_string) {
+               const auto width = header_width(h);
+               if (width && n > size_t(end - it) / width) {
+                  return fail();
+               }
+               it += n * width;
+            }
+            else if ((h >> 5) & 1) {
+               for (size_t i = 0; i < n && ok; ++i) {
+                  string_body();
+               }
+            }
+            else {
+               bytes((n + 7) / 8); // packed booleans
+            }
+            return ok;
+         }
+         case type::array: {
+            const auto n = compressed();
+            for (size_t i = 0; i < n && ok; ++i) {
+               skip(depth + 1);
+            }
+            return ok;
+         }
+         case type::extension:
+            if ((h >> 3) == 1) { // variant: type index, then the value
+               compressed();
+               return ok && skip(depth + 1);
+            }
+            return fail();
+         default:
+            return fail();
+         }
+      }
+   };
+
+   // Follows object keys from the value at the cursor and leaves the cursor at the value of the last key, skipping
+   // every other member on the way. Returns false when a key is missing or the input is malformed.
+   inline bool find(cursor& c, std::initializer_list<std::string_view> path)
+   {
+      for (const auto key : path) {
+         const auto n = c.object();
+         bool found = false;
+         for (size_t i = 0; i < n && c.ok && !found; ++i) {
+            found = c.key() == key;
+            if (!found) {
+               c.skip();
+            }
+         }
+         if (!found) {
+            return false;
+         }
+      }
+      return c.ok;
+   }
+
+   // True when `in` is exactly one well-formed value
+   inline bool validate(std::string_view in)
+   {
+      cursor c{in};
+      return c.skip() && c.it == c.end;
+   }
+}
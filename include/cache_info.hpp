@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+// Data cache sizes of the first CPU, read from sysfs on Linux. Unknown levels are 0.
+
+struct cache_info
+{
+   uint64_t l1d{};
+   uint64_t l2{};
+   uint64_t llc{}; // largest (last) level found
+
+   // Smallest level the working set fits in
+   std::string_view level(uint64_t bytes) const
+   {
+      if (l1d && bytes <= l1d) {
+         return "L1";
+      }
+      if (l2 && bytes <= l2) {
+         return "L2";
+      }
+      if (llc && bytes <= llc) {
+         return "LLC";
+      }
+      return (l1d || l2 || llc) ? "DRAM" : "?";
+   }
+};
+
+// Parses sysfs sizes such as "48K" or "32768K"
+inline uint64_t parse_cache_size(const std::string& text)
+{
+   uint64_t value{};
+   size_t i{};
+   while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+      value = value * 10 + uint64_t(text[i] - '0');
+      ++i;
+   }
+   if (i < text.size()) {
+      switch (text[i]) {
+      case 'K':
+         return value << 10;
+      case 'M':
+         return value << 20;
+      case 'G':
+         return value << 30;
+      default:
+         break;
+      }
+   }
+   return value;
+}
+
+inline const cache_info& detect_caches()
+{
+   static const cache_info info = [] {
+      cache_info c{};
+      for (int index = 0; index < 8; ++index) {
+         const auto dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+         std::ifstream level_file(dir + "level");
+         std::ifstream type_file(dir + "type");
+         std::ifstream size_file(dir + "size");
+         int level{};
+         std::string type, size;
+         if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size)) {
+            continue;
+         }
+         if (type == "Instruction") {
+            continue;
+         }
+         const auto bytes = parse_cache_size(size);
+         if (level == 1) {
+            c.l1d = bytes;
+         }
+         else if (level == 2) {
+            c.l2 = bytes;
+         }
+         if (level >= 2 && bytes >= c.llc) {
+            c.llc = bytes;
+         }
+      }
+      return c;
+   }();
+   return info;
+}
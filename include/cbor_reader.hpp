@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Minimal forward-only CBOR reader (RFC 8949) for structural validation: it skips one complete data item at a time
+// and checks that every length fits the input. Tags, including the RFC 8746 typed arrays Glaze writes, are skipped
+// together with the item they wrap. UTF-8 and the meaning of tags and simple values are not checked.
+
+namespace cbor
+{
+   // High three bits of the initial byte
+   enum struct major : uint8_t { unsigned_int, negative_int, bytes, text, array, map, tag, simple };
+
+   constexpr uint8_t indefinite_length = 31; // low five bits of an indefinite length item
+   constexpr uint8_t break_byte = 0xff; // ends an indefinite length item
+
+   struct cursor
+   {
+      const char* it{};
+      const char* end{};
+      bool ok = true;
+
+      cursor() = default;
+      cursor(const char* data, size_t size) : it(data), end(data + size) {}
+      explicit cursor(std::string_view buffer) : cursor(buffer.data(), buffer.size()) {}
+
+      bool fail()
+      {
+         ok = false;
+         it = end;
+         return false;
+      }
+
+      bool has(size_t n) const { return size_t(end - it) >= n; }
+
+      bool at_break() const { return it < end && uint8_t(*it) == break_byte; }
+
+      // The argument of an initial byte whose low five bits are `info`: the value itself below 24, otherwise the 1, 2,
+      // 4 or 8 big-endian bytes that follow. Not valid for indefinite lengths.
+      uint64_t argument(uint8_t info)
+      {
+         if (info < 24) {
+            return info;
+         }
+         if (info > 27) {
+            fail();
+            return 0;
+         }
+         const auto n = size_t(1) << (info - 24);
+         if (!has(n)) {
+            fail();
+            return 0;
+         }
+         uint64_t value{};
+         for (size_t i = 0; i < n; ++i) {
+            value = value << 8 | uint8_t(it[i]);
+         }
+         it += n;
+         return value;
+      }
+
+      // Skips items until the break that ends an indefinite length item, `items` at a time (2 for maps)
+      bool skip_until_break(size_t items, size_t depth)
+      {
+         while (!at_break()) {
+            for (size_t i = 0; i < items; ++i) {
+               if (!skip(depth + 1)) {
+                  return false;
+               }
+            }
+         }
+         ++it;
+         return true;
+      }
+
+      // Skips one complete data item. Returns false on malformed or truncated input.
+      bool skip(size_t depth = 0)
+      {
+         if (depth > 512 || !has(1)) {
+            return fail();
+         }
+         const auto initial = uint8_t(*it++);
+         const auto type = major(initial >> 5);
+         const auto info = uint8_t(initial & 0x1f);
+         const bool indefinite = info == indefinite_length;
+         if (indefinite) {
+            switch (type) {
+            case major::bytes:
+            case major::text:
+               // definite length chunks of the same type
+               while (!at_break()) {
+                  if (!has(1) || major(uint8_t(*it) >> 5) != type || (uint8_t(*it) & 0x1f) == indefinite_length) {
+                     return fail();
+                  }
+                  if (!skip(depth + 1)) {
+                     return false;
+                  }
+               }
+               ++it;
+               return true;
+            case major::array:
+               return skip_until_break(1, depth);
+            case major::map:
+               return skip_until_break(2, depth);
+            default:
+               return fail(); // includes a break outside an indefinite length item
+            }
+         }
+
+         const auto n = argument(info);
+         if (!ok) {
+            return false;
+         }
+         switch (type) {
+         case major::unsigned_int:
+         case major::negative_int:
+         case major::simple: // simple values and floats carry nothing past their argument
+            return true;
+         case major::bytes:
+         case major::text:
+            if (n > uint64_t(end - it)) {
+               return fail();
+            }
+            it += n;
+            return true;
+         case major::array:
+         case major::map: {
+            if (n > uint64_t(end - it)) {
+               return fail(); // every item takes at least one byte
+            }
+            const auto items = type == major::map ? 2 * n : n;
+            for (uint64_t i = 0; i < items; ++i) {
+               if (!skip(depth + 1)) {
+                  return false;
+               }
+            }
+            return true;
+         }
+         case major::tag:
+            return skip(depth + 1);
+         }
+         return fail();
+      }
+   };
+
+   // True when `in` is exactly one well-formed data item
+   inline bool validate(std::string_view in)
+   {
+      cursor c{in};
+      return c.skip() && c.it == c.end;
+   }
+}
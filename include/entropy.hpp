@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef BINARY_PERF_ZLIB
+#include <zlib.h>
+#endif
+
+// Optional entropy stage after a codec: zlib deflate at its fastest level. The stream state is kept across calls and
+// reset per message, since deflateInit allocates a few hundred KB. Each compressed message starts with its 4 byte
+// little-endian uncompressed size so the decoder can size its output up front. Without zlib (BINARY_PERF_ZLIB unset
+// by CMake) available is false and compress/decompress fail.
+
+namespace entropy
+{
+#ifdef BINARY_PERF_ZLIB
+   inline constexpr bool available = true;
+#else
+   inline constexpr bool available = false;
+#endif
+
+   constexpr size_t header_size = 4;
+
+   class compressor
+   {
+     public:
+      compressor()
+      {
+#ifdef BINARY_PERF_ZLIB
+         valid = deflateInit(&stream, Z_BEST_SPEED) == Z_OK;
+#endif
+      }
+
+      compressor(const compressor&) = delete;
+      compressor& operator=(const compressor&) = delete;
+
+      ~compressor()
+      {
+#ifdef BINARY_PERF_ZLIB
+         if (valid) {
+            deflateEnd(&stream);
+         }
+#endif
+      }
+
+      // Replaces out with the compressed message
+      bool compress(std::string_view in, std::string& out)
+      {
+#ifdef BINARY_PERF_ZLIB
+         if (!valid || deflateReset(&stream) != Z_OK || in.size() > UINT32_MAX) {
+            return false;
+         }
+         out.resize(header_size + deflateBound(&stream, uLong(in.size())));
+         for (size_t i = 0; i < header_size; ++i) {
+            out[i] = char(in.size() >> (8 * i));
+         }
+         stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+         stream.avail_in = uInt(in.size());
+         stream.next_out = reinterpret_cast<Bytef*>(out.data() + header_size);
+         stream.avail_out = uInt(out.size() - header_size);
+         if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+            return false;
+         }
+         out.resize(header_size + stream.total_out);
+         return true;
+#else
+         (void)in;
+         (void)out;
+         return false;
+#endif
+      }
+
+     private:
+#ifdef BINARY_PERF_ZLIB
+      z_stream stream{};
+#endif
+      bool valid = false;
+   };
+
+   class decompressor
+   {
+     public:
+      decompressor()
+      {
+#ifdef BINARY_PERF_ZLIB
+         valid = inflateInit(&stream) == Z_OK;
+#endif
+      }
+
+      decompressor(const decompressor&) = delete;
+      decompressor& operator=(const decompressor&) = delete;
+
+      ~decompressor()
+      {
+#ifdef BINARY_PERF_ZLIB
+         if (valid) {
+            inflateEnd(&stream);
+         }
+#endif
+      }
+
+      // Replaces out with the decompressed message
+      bool decompress(std::string_view in, std::string& out)
+      {
+#ifdef BINARY_PERF_ZLIB
+         if (!valid || in.size() < header_size || inflateReset(&stream) != Z_OK) {
+            return false;
+         }
+         size_t size{};
+         for (size_t i = 0; i < header_size; ++i) {
+            size |= size_t(uint8_t(in[i])) << (8 * i);
+         }
+         out.resize(size);
+         stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data() + header_size));
+         stream.avail_in = uInt(in.size() - header_size);
+         stream.next_out = reinterpret_cast<Bytef*>(out.data());
+         stream.avail_out = uInt(size);
+         return inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == size;
+#else
+         (void)in;
+         (void)out;
+         return false;
+#endif
+      }
+
+     private:
+#ifdef BINARY_PERF_ZLIB
+      z_stream stream{};
+#endif
+      bool valid = false;
+   };
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Compile-time field tables for the hand-written readers and writers. A specialization of fields<T> lists every
+// member with its name, in declaration order; protobuf field numbers are the 1-based positions in that list, which
+// matches how zpp_bits numbers pb_protocol members. A field may set its own number instead, so that a struct for
+// another version of a schema can leave out or reorder fields and keep the numbers on the wire.
+
+template <class T, class M>
+struct field
+{
+   std::string_view name;
+   M T::*member;
+   uint32_t number = 0; // 0 for the position in the table
+};
+
+template <class T, class M>
+field(std::string_view, M T::*) -> field<T, M>;
+
+template <class T, class M>
+field(std::string_view, M T::*, uint32_t) -> field<T, M>;
+
+template <class T>
+struct fields;
+
+template <class T>
+concept has_fields = requires { fields<T>::value; };
+
+// std::string and char strings with another allocator, such as std::pmr::string
+template <class T>
+struct is_char_string : std::false_type
+{};
+
+template <class Traits, class A>
+struct is_char_string<std::basic_string<char, Traits, A>> : std::true_type
+{};
+
+template <class T>
+concept char_string = is_char_string<T>::value;
+
+template <class T>
+constexpr size_t field_count = std::tuple_size_v<std::remove_cvref_t<decltype(fields<T>::value)>>;
+
+// Protobuf field number of the field at `index` in the table of T
+template <class T, size_t Index>
+constexpr uint32_t field_number()
+{
+   const auto number = std::get<Index>(fields<T>::value).number;
+   return number ? number : uint32_t(Index + 1);
+}
+
+// Calls f(value.*member, name, number) for every field, in table order
+template <class T, class F>
+constexpr void for_each_field(T& value, F&& f)
+{
+   using U = std::remove_const_t<T>;
+   [&]<size_t... I>(std::index_sequence<I...>) {
+      (f(value.*(std::get<I>(fields<U>::value).member), std::get<I>(fields<U>::value).name, field_number<U, I>()),
+       ...);
+   }(std::make_index_sequence<field_count<U>>{});
+}
+
+// Calls f(value.*member) for the field called `name`. Returns false when there is no such field.
+template <class T, class F>
+constexpr bool visit_field(T& value, std::string_view name, F&& f)
+{
+   bool found = false;
+   for_each_field(value, [&](auto& member, std::string_view field_name, uint32_t) {
+      if (!found && field_name == name) {
+         found = true;
+         f(member);
+      }
+   });
+   return found;
+}
+
+// Calls f(value.*member) for protobuf field `number`. Returns false when there is no such field.
+template <class T, class F>
+constexpr bool visit_field(T& value, uint32_t number, F&& f)
+{
+   bool found = false;
+   for_each_field(value, [&](auto& member, std::string_view, uint32_t field_number) {
+      if (!found && field_number == number) {
+         found = true;
+         f(member);
+      }
+   });
+   return found;
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "record_log.hpp"
+
+// Local stream sockets for the RPC benchmark: a listener on a Unix domain socket or an ephemeral TCP port on
+// 127.0.0.1, and connections that exchange messages framed like record_log records (4 byte little-endian length,
+// then the payload). A frame is sent with one sendmsg(2) and received with two reads of exact length. TCP sockets
+// have Nagle's algorithm disabled, since every frame is a complete request or reply.
+
+namespace loopback
+{
+   enum struct transport : uint8_t { unix_socket, tcp };
+
+   constexpr std::string_view transport_name(transport t) { return t == transport::tcp ? "TCP" : "Unix socket"; }
+
+   inline void set_nodelay(int fd)
+   {
+      const int one = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+   }
+
+   class connection
+   {
+     public:
+      connection() = default;
+      explicit connection(int fd) : fd(fd) {}
+
+      connection(connection&& other) noexcept : fd(other.fd) { other.fd = -1; }
+      connection& operator=(connection&& other) noexcept
+      {
+         std::swap(fd, other.fd);
+         return *this;
+      }
+
+      ~connection()
+      {
+         if (fd >= 0) {
+            ::close(fd);
+         }
+      }
+
+      bool ok() const { return fd >= 0; }
+
+      bool send(std::string_view payload)
+      {
+         char prefix[record_log::prefix_size];
+         record_log::put_prefix(prefix, uint32_t(payload.size()));
+         iovec parts[2]{{prefix, sizeof(prefix)}, {const_cast<char*>(payload.data()), payload.size()}};
+         msghdr msg{};
+         msg.msg_iov = parts;
+         msg.msg_iovlen = 2;
+         size_t left = sizeof(prefix) + payload.size();
+         while (left > 0) {
+            const auto n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+               continue;
+            }
+            if (n <= 0) {
+               return false;
+            }
+            left -= size_t(n);
+            // skip what was sent on a partial write
+            auto sent = size_t(n);
+            while (msg.msg_iovlen > 0 && sent >= msg.msg_iov->iov_len) {
+               sent -= msg.msg_iov->iov_len;
+               ++msg.msg_iov;
+               --msg.msg_iovlen;
+            }
+            if (msg.msg_iovlen > 0) {
+               msg.msg_iov->iov_base = static_cast<char*>(msg.msg_iov->iov_base) + sent;
+               msg.msg_iov->iov_len -= sent;
+            }
+         }
+         return true;
+      }
+
+      // Replaces payload with the next frame; false once the peer has closed the connection
+      bool receive(std::string& payload)
+      {
+         char prefix[record_log::prefix_size];
+         if (!read_exact(prefix, sizeof(prefix))) {
+            return false;
+         }
+         payload.resize(record_log::get_prefix(prefix));
+         return read_exact(payload.data(), payload.size());
+      }
+
+      // Tells the peer that no more frames follow
+      void finish() { ::shutdown(fd, SHUT_WR); }
+
+     private:
+      bool read_exact(char* out, size_t size)
+      {
+         while (size > 0) {
+            const auto n = ::recv(fd, out, size, 0);
+            if (n < 0 && errno == EINTR) {
+               continue;
+            }
+            if (n <= 0) {
+               return false;
+            }
+            out += n;
+            size -= size_t(n);
+         }
+         return true;
+      }
+
+      int fd = -1;
+   };
+
+   class listener
+   {
+     public:
+      // path names the Unix socket and is ignored for TCP
+      listener(transport t, std::string path) : kind(t), path(std::move(path))
+      {
+         if (kind == transport::unix_socket) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (this->path.size() >= sizeof(addr.sun_path)) {
+               return;
+            }
+            std::memcpy(addr.sun_path, this->path.c_str(), this->path.size() + 1);
+            ::unlink(this->path.c_str());
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+               return;
+            }
+         }
+         else {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0; // any free port
+            socklen_t size = sizeof(addr);
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &size) != 0) {
+               return;
+            }
+            port = addr.sin_port;
+         }
+         valid = ::listen(fd, SOMAXCONN) == 0;
+      }
+
+      listener(const listener&) = delete;
+      listener& operator=(const listener&) = delete;
+
+      ~listener()
+      {
+         if (fd >= 0) {
+            ::close(fd);
+         }
+         if (kind == transport::unix_socket) {
+            ::unlink(path.c_str());
+         }
+      }
+
+      bool ok() const { return valid; }
+
+      connection accept()
+      {
+         const int client = ::accept(fd, nullptr, nullptr);
+         if (client >= 0 && kind == transport::tcp) {
+            set_nodelay(client);
+         }
+         return connection{client};
+      }
+
+      // A client connection; the listen backlog holds it until accept()
+      connection connect() const
+      {
+         int client = -1;
+         if (kind == transport::unix_socket) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (client >= 0 && ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+               ::close(client);
+               client = -1;
+            }
+         }
+         else {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = port;
+            client = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (client >= 0 && ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+               ::close(client);
+               client = -1;
+            }
+            if (client >= 0) {
+               set_nodelay(client);
+            }
+         }
+         return connection{client};
+      }
+
+     private:
+      transport kind{};
+      std::string path{};
+      int fd = -1;
+      in_port_t port{};
+      bool valid = false;
+   };
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "perf_counters.hpp"
+
+// Shared measurement engine: warmup, N independent trials, and sampled per-operation latencies.
+
+struct measure_config
+{
+   size_t trials = 10;
+   double warmup_fraction = 0.1; // warmup operations as a fraction of the measured operations
+   size_t sample_stride = 16; // every Nth operation is timed individually for the latency histogram
+   bool counters = true; // collect hardware performance counters over the trials when the kernel allows it
+   double target_seconds = 0.1; // duration of each phase timed with measure_for
+};
+
+inline measure_config measure_defaults{};
+
+// Log-linear latency histogram in nanoseconds (32 sub-buckets per power of two, ~3% resolution)
+struct latency_histogram
+{
+   static constexpr uint64_t sub_bits = 5;
+   static constexpr uint64_t sub_count = uint64_t(1) << sub_bits;
+   static constexpr size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+   std::vector<uint64_t> counts = std::vector<uint64_t>(bucket_count);
+   uint64_t total{};
+   uint64_t min = (std::numeric_limits<uint64_t>::max)();
+   uint64_t max{};
+
+   static constexpr size_t index(uint64_t ns)
+   {
+      if (ns < sub_count) {
+         return size_t(ns);
+      }
+      const auto e = uint64_t(std::bit_width(ns)) - 1;
+      const auto sub = (ns >> (e - sub_bits)) & (sub_count - 1);
+      return size_t((e - sub_bits + 1) * sub_count + sub);
+   }
+
+   // midpoint of the bucket range
+   static constexpr double value(size_t i)
+   {
+      if (i < sub_count) {
+         return double(i);
+      }
+      const auto e = i / sub_count + sub_bits - 1;
+      const auto sub = i % sub_count;
+      const auto width = uint64_t(1) << (e - sub_bits);
+      return double((sub_count + sub) * width) + 0.5 * double(width);
+   }
+
+   void record(uint64_t ns)
+   {
+      ++counts[index(ns)];
+      ++total;
+      min = (std::min)(min, ns);
+      max = (std::max)(max, ns);
+   }
+
+   // p in [0, 1], returns nanoseconds
+   double percentile(double p) const
+   {
+      if (total == 0) {
+         return 0.0;
+      }
+      const auto target = uint64_t(std::ceil(p * double(total)));
+      uint64_t seen{};
+      for (size_t i = 0; i < counts.size(); ++i) {
+         seen += counts[i];
+         if (seen >= (std::max)(target, uint64_t(1))) {
+            return std::clamp(value(i), double(min), double(max));
+         }
+      }
+      return double(max);
+   }
+};
+
+// Two-sided 95% Student t critical values for 1..30 degrees of freedom
+inline double t_critical_95(size_t df)
+{
+   static constexpr double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+   if (df == 0) {
+      return 0.0;
+   }
+   return df <= 30 ? table[df - 1] : 1.960;
+}
+
+struct measurement
+{
+   std::vector<double> trials; // seconds per operation, one entry per trial
+   latency_histogram latency;
+   size_t operations{}; // measured operations across all trials, excluding warmup
+   perf_counts counters{}; // totals over all trials
+   alloc_counts allocs{}; // totals over all trials
+
+   double median() const
+   {
+      if (trials.empty()) {
+         return 0.0;
+      }
+      auto sorted = trials;
+      std::sort(sorted.begin(), sorted.end());
+      const auto n = sorted.size();
+      return n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+   }
+
+   double mean() const
+   {
+      if (trials.empty()) {
+         return 0.0;
+      }
+      return std::accumulate(trials.begin(), trials.end(), 0.0) / double(trials.size());
+   }
+
+   double stddev() const
+   {
+      if (trials.size() < 2) {
+         return 0.0;
+      }
+      const auto m = mean();
+      double sum{};
+      for (auto t : trials) {
+         sum += (t - m) * (t - m);
+      }
+      return std::sqrt(sum / double(trials.size() - 1));
+   }
+
+   // Half-width of the distribution-free 95% confidence interval of the median, in seconds per operation: the
+   // widest distance from the median to the order statistics x(j+1) and x(n-j), where j is the largest rank whose
+   // binomial coverage 1 - 2 P(X <= j), X ~ B(n, 1/2), is still at least 95%. Below 6 trials no pair reaches 95%
+   // and the full range of the trials is used.
+   double ci95() const
+   {
+      if (trials.size() < 2) {
+         return 0.0;
+      }
+      auto sorted = trials;
+      std::sort(sorted.begin(), sorted.end());
+      const auto n = sorted.size();
+      size_t j = 0;
+      double term = std::pow(0.5, double(n)); // P(X = i), starting at i = 0
+      double tail = term;
+      for (size_t i = 1; i < n / 2; ++i) {
+         term *= double(n - i + 1) / double(i);
+         tail += term;
+         if (1.0 - 2.0 * tail < 0.95) {
+            break;
+         }
+         j = i;
+      }
+      const auto m = median();
+      return (std::max)(m - sorted[j], sorted[n - 1 - j] - m);
+   }
+};
+
+// Welch's unequal-variance t test for a difference between the trial means of two measurements, at the 95% level.
+// df is the Welch-Satterthwaite estimate, rounded down for the critical value.
+struct welch_result
+{
+   double t{};
+   double df{};
+   bool significant{};
+};
+
+inline welch_result welch_test(const measurement& a, const measurement& b)
+{
+   const auto na = double(a.trials.size());
+   const auto nb = double(b.trials.size());
+   if (na < 2 || nb < 2) {
+      return {};
+   }
+   const auto va = a.stddev() * a.stddev() / na;
+   const auto vb = b.stddev() * b.stddev() / nb;
+   const auto se2 = va + vb;
+   if (se2 <= 0.0) {
+      return {0.0, na + nb - 2, a.mean() != b.mean()};
+   }
+   welch_result w{};
+   w.t = (b.mean() - a.mean()) / std::sqrt(se2);
+   w.df = se2 * se2 / (va * va / (na - 1) + vb * vb / (nb - 1));
+   w.significant = std::abs(w.t) > t_critical_95((std::max)(size_t(w.df), size_t(1)));
+   return w;
+}
+
+// Smallest observable steady_clock interval, subtracted from individually timed operations
+inline uint64_t clock_overhead_ns()
+{
+   static const uint64_t overhead = [] {
+      auto best = (std::numeric_limits<int64_t>::max)();
+      for (size_t i = 0; i < 1000; ++i) {
+         const auto t0 = std::chrono::steady_clock::now();
+         const auto t1 = std::chrono::steady_clock::now();
+         best = (std::min)(best, int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+      }
+      return uint64_t(best);
+   }();
+   return overhead;
+}
+
+// Runs `op` for `iterations` operations split across trials, after a warmup phase
+template <class Op>
+measurement measure(size_t iterations, Op&& op, const measure_config& cfg = measure_defaults)
+{
+   using clock = std::chrono::steady_clock;
+
+   const auto warmup = size_t(double(iterations) * cfg.warmup_fraction);
+   for (size_t i = 0; i < warmup; ++i) {
+      op();
+   }
+
+   const auto trials = (std::max)(cfg.trials, size_t(1));
+   const auto per_trial = (std::max)(iterations / trials, size_t(1));
+   const auto stride = (std::max)(cfg.sample_stride, size_t(1));
+   const auto overhead = clock_overhead_ns();
+
+   std::optional<perf_counters> pmu{};
+   if (cfg.counters && perf_counters_available()) {
+      pmu.emplace();
+   }
+
+   measurement m{};
+   m.trials.reserve(trials);
+   m.operations = per_trial * trials;
+   const auto allocs_before = thread_alloc_counts;
+   if (pmu) {
+      pmu->start();
+   }
+   for (size_t t = 0; t < trials; ++t) {
+      size_t samples = 0;
+      const auto t0 = clock::now();
+      for (size_t i = 0; i < per_trial; i += stride, ++samples) {
+         const auto s0 = clock::now();
+         op();
+         const auto s1 = clock::now();
+         const auto ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(s1 - s0).count());
+         m.latency.record(ns > overhead ? ns - overhead : 0);
+
+         const auto end = (std::min)(i + stride, per_trial);
+         for (size_t j = i + 1; j < end; ++j) {
+            op();
+         }
+      }
+      const auto t1 = clock::now();
+      // the two clock reads around each sampled operation are not part of its cost
+      const auto elapsed = std::chrono::duration<double>(t1 - t0).count() - double(samples * 2 * overhead) * 1e-9;
+      m.trials.push_back((std::max)(elapsed, 0.0) / double(per_trial));
+   }
+   if (pmu) {
+      m.counters = pmu->stop();
+   }
+   m.allocs = thread_alloc_counts - allocs_before;
+   return m;
+}
+
+// Picks an operation count that makes the measured trials last about target_seconds (at least min_iterations)
+template <class Op>
+size_t calibrate_iterations(Op&& op, double target_seconds, size_t min_iterations)
+{
+   using clock = std::chrono::steady_clock;
+   constexpr size_t max_iterations = size_t(1) << 28;
+
+   for (size_t n = 1;; n *= 4) {
+      const auto t0 = clock::now();
+      for (size_t i = 0; i < n; ++i) {
+         op();
+      }
+      const auto elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+      if (elapsed >= 0.01 || n >= max_iterations) {
+         const auto per_op = (std::max)(elapsed / double(n), target_seconds / double(max_iterations));
+         return (std::max)(min_iterations, size_t(target_seconds / per_op));
+      }
+   }
+}
+
+// measure() with the iteration count scaled to the cost of one operation
+template <class Op>
+measurement measure_for(double target_seconds, Op&& op, const measure_config& cfg = measure_defaults)
+{
+   return measure(calibrate_iterations(op, target_seconds, cfg.trials), op, cfg);
+}
+
+// measure_for() over the configured duration, the runner shared by every mode
+template <class Op>
+measurement measure_for(Op&& op, const measure_config& cfg = measure_defaults)
+{
+   return measure_for(cfg.target_seconds, op, cfg);
+}
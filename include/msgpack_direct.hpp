@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifndef MSGPACK_NO_BOOST
+#define MSGPACK_NO_BOOST
+#endif
+#include "msgpack.hpp"
+
+#include "fields.hpp"
+
+// MessagePack decoding straight into C++ objects with the msgpack-c parse/visitor API: no msgpack::object tree and no
+// zone. Maps are matched to structs through their fields<T> table by key, arrays to std::vector (resized, so element
+// capacity is reused) or std::array, strings are assigned from the input buffer. Unknown keys are skipped and
+// members missing from the input keep their value, as with msgpack-c's convert().
+
+namespace msgpack_direct
+{
+   // Type-erased destination of one value. Every callback returns false when the value does not fit the target.
+   struct sink_table;
+
+   struct sink
+   {
+      void* target{};
+      const sink_table* table{};
+   };
+
+   struct sink_table
+   {
+      bool (*boolean)(void*, bool);
+      bool (*integer)(void*, int64_t);
+      bool (*unsigned_integer)(void*, uint64_t);
+      bool (*floating)(void*, double);
+      bool (*string)(void*, std::string_view);
+      bool (*start_array)(void*, uint32_t);
+      sink (*array_item)(void*, size_t);
+      bool (*start_map)(void*, uint32_t);
+      sink (*map_value)(void*, std::string_view);
+   };
+
+   // Accepts and drops any value
+   inline constexpr sink_table skip_table{
+      [](void*, bool) { return true; },
+      [](void*, int64_t) { return true; },
+      [](void*, uint64_t) { return true; },
+      [](void*, double) { return true; },
+      [](void*, std::string_view) { return true; },
+      [](void*, uint32_t) { return true; },
+      [](void*, size_t) { return sink{nullptr, &skip_table}; },
+      [](void*, uint32_t) { return true; },
+      [](void*, std::string_view) { return sink{nullptr, &skip_table}; },
+   };
+
+   template <class T>
+   struct is_vector : std::false_type
+   {};
+
+   template <class T, class A>
+   struct is_vector<std::vector<T, A>> : std::true_type
+   {};
+
+   template <class T>
+   struct is_array : std::false_type
+   {};
+
+   template <class T, size_t N>
+   struct is_array<std::array<T, N>> : std::true_type
+   {};
+
+   template <class T>
+   const sink_table& table_for();
+
+   template <class T>
+   sink make_sink(T& value)
+   {
+      return {&value, &table_for<T>()};
+   }
+
+   template <class T>
+   constexpr sink_table make_table()
+   {
+      sink_table t{skip_table};
+      t.boolean = [](void*, bool) { return false; };
+      t.integer = [](void*, int64_t) { return false; };
+      t.unsigned_integer = [](void*, uint64_t) { return false; };
+      t.floating = [](void*, double) { return false; };
+      t.string = [](void*, std::string_view) { return false; };
+      t.start_array = [](void*, uint32_t) { return false; };
+      t.start_map = [](void*, uint32_t) { return false; };
+
+      if constexpr (std::same_as<T, bool>) {
+         t.boolean = [](void* p, bool v) { return *static_cast<T*>(p) = v, true; };
+      }
+      else if constexpr (std::is_arithmetic_v<T>) {
+         t.integer = [](void* p, int64_t v) { return *static_cast<T*>(p) = T(v), true; };
+         t.unsigned_integer = [](void* p, uint64_t v) { return *static_cast<T*>(p) = T(v), true; };
+         if constexpr (std::is_floating_point_v<T>) {
+            t.floating = [](void* p, double v) { return *static_cast<T*>(p) = T(v), true; };
+         }
+      }
+      else if constexpr (char_string<T>) {
+         t.string = [](void* p, std::string_view v) {
+            static_cast<T*>(p)->assign(v.data(), v.size());
+            return true;
+         };
+      }
+      else if constexpr (is_vector<T>::value) {
+         t.start_array = [](void* p, uint32_t n) {
+            static_cast<T*>(p)->resize(n);
+            return true;
+         };
+         t.array_item = [](void* p, size_t i) { return make_sink((*static_cast<T*>(p))[i]); };
+      }
+      else if constexpr (is_array<T>::value) {
+         t.start_array = [](void*, uint32_t n) { return n == std::tuple_size_v<T>; };
+         t.array_item = [](void* p, size_t i) { return make_sink((*static_cast<T*>(p))[i]); };
+      }
+      else if constexpr (has_fields<T>) {
+         t.start_map = [](void*, uint32_t) { return true; };
+         t.map_value = [](void* p, std::string_view key) {
+            sink s{nullptr, &skip_table};
+            visit_field(*static_cast<T*>(p), key, [&](auto& member) { s = make_sink(member); });
+            return s;
+         };
+      }
+      return t;
+   }
+
+   template <class T>
+   const sink_table& table_for()
+   {
+      static constexpr sink_table table = make_table<T>();
+      return table;
+   }
+
+   // A sink on the parse stack; for arrays, also the index of the next item
+   struct frame
+   {
+      sink target{};
+      size_t next{};
+   };
+
+   // Routes msgpack-c parse events to the sink on top of a stack: containers stay on the stack while their items or
+   // values are pushed and popped around each element.
+   class visitor : public msgpack::null_visitor
+   {
+     public:
+      explicit visitor(std::vector<frame>& stack) : stack(stack) {}
+
+      bool visit_nil() { return !in_key; }
+      bool visit_boolean(bool v) { return !in_key && top().table->boolean(top().target, v); }
+      bool visit_positive_integer(uint64_t v) { return !in_key && top().table->unsigned_integer(top().target, v); }
+      bool visit_negative_integer(int64_t v) { return !in_key && top().table->integer(top().target, v); }
+      bool visit_float32(float v) { return !in_key && top().table->floating(top().target, v); }
+      bool visit_float64(double v) { return !in_key && top().table->floating(top().target, v); }
+
+      bool visit_str(const char* v, uint32_t size)
+      {
+         if (in_key) {
+            key = {v, size};
+            return true;
+         }
+         return top().table->string(top().target, {v, size});
+      }
+
+      bool visit_bin(const char*, uint32_t) { return false; }
+      bool visit_ext(const char*, uint32_t) { return false; }
+
+      bool start_array(uint32_t n)
+      {
+         stack.back().next = 0;
+         return !in_key && top().table->start_array(top().target, n);
+      }
+
+      bool start_array_item()
+      {
+         const auto item = top().table->array_item(top().target, stack.back().next++);
+         stack.push_back({item});
+         return true;
+      }
+
+      bool end_array_item()
+      {
+         stack.pop_back();
+         return true;
+      }
+
+      bool end_array() { return true; }
+
+      bool start_map(uint32_t n) { return !in_key && top().table->start_map(top().target, n); }
+
+      bool start_map_key()
+      {
+         in_key = true;
+         key = {};
+         return true;
+      }
+
+      bool end_map_key()
+      {
+         in_key = false;
+         return true;
+      }
+
+      bool start_map_value()
+      {
+         const auto value = top().table->map_value(top().target, key);
+         stack.push_back({value});
+         return true;
+      }
+
+      bool end_map_value()
+      {
+         stack.pop_back();
+         return true;
+      }
+
+      bool end_map() { return true; }
+
+      void parse_error(size_t, size_t) {}
+      void insufficient_bytes(size_t, size_t) {}
+
+     private:
+      const sink& top() const { return stack.back().target; }
+
+      std::vector<frame>& stack;
+      std::string_view key{};
+      bool in_key = false;
+   };
+
+   // Keeps the sink stack between messages so that steady-state decoding does not allocate for parsing
+   class reader
+   {
+     public:
+      template <class T>
+      bool read(std::string_view in, T& value)
+      {
+         stack.clear();
+         stack.push_back({make_sink(value)});
+         visitor v{stack};
+         size_t offset = 0;
+         return msgpack::parse(in.data(), in.size(), offset, v) && offset == in.size();
+      }
+
+     private:
+      std::vector<frame> stack{};
+   };
+}
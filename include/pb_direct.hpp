@@ -0,0 +1,476 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "fields.hpp"
+#include "pb_wire.hpp"
+
+// Protocol Buffers encoding of plain C++ structs straight from their fields<T> table, with no shadow message types
+// or conversion. Field numbers come from the table (fields.hpp). Types map as in proto3:
+//   bool, unsigned integers -> varint; signed integers -> zig-zag varint (sint32/sint64); float -> fixed32;
+//   double -> fixed64; strings (any allocator) -> bytes; std::vector of numbers -> packed; std::vector of anything
+//   else -> repeated; std::array<T, N> -> message with fields 1..N; types with a field table -> message.
+// Zero scalars and empty strings and vectors are not written. Decoding reuses the capacity of the strings and
+// vectors already in the destination, and resets fields that are missing from the input.
+
+namespace pb_direct
+{
+   template <class T>
+   struct is_vector : std::false_type
+   {};
+
+   template <class T, class A>
+   struct is_vector<std::vector<T, A>> : std::true_type
+   {};
+
+   template <class T>
+   struct is_array : std::false_type
+   {};
+
+   template <class T, size_t N>
+   struct is_array<std::array<T, N>> : std::true_type
+   {};
+
+   template <class T>
+   concept scalar = std::is_arithmetic_v<T>;
+
+   template <class T>
+   concept message = has_fields<T> || is_array<T>::value;
+
+   template <scalar T>
+   constexpr pb_wire::wire_type scalar_wire_type()
+   {
+      if constexpr (std::same_as<T, float>) {
+         return pb_wire::wire_type::fixed32;
+      }
+      else if constexpr (std::same_as<T, double>) {
+         return pb_wire::wire_type::fixed64;
+      }
+      else {
+         return pb_wire::wire_type::varint;
+      }
+   }
+
+   template <scalar T>
+   constexpr uint64_t varint_value(T v)
+   {
+      if constexpr (std::same_as<T, bool>) {
+         return v;
+      }
+      else if constexpr (std::is_signed_v<T>) {
+         return sizeof(T) <= 4 ? pb_wire::zigzag32(int32_t(v)) : pb_wire::zigzag64(int64_t(v));
+      }
+      else {
+         return uint64_t(v);
+      }
+   }
+
+   template <scalar T>
+   constexpr size_t scalar_size(T v)
+   {
+      if constexpr (std::is_floating_point_v<T>) {
+         return sizeof(T);
+      }
+      else {
+         return pb_wire::varint_size(varint_value(v));
+      }
+   }
+
+   template <scalar T>
+   char* put_scalar(char* out, T v)
+   {
+      if constexpr (std::is_floating_point_v<T>) {
+         return pb_wire::put_fixed(out, v);
+      }
+      else {
+         return pb_wire::put_varint(out, varint_value(v));
+      }
+   }
+
+   template <scalar T>
+   T get_scalar(pb_wire::cursor& c, pb_wire::wire_type type)
+   {
+      if (type != scalar_wire_type<T>()) {
+         c.fail();
+         return T{};
+      }
+      if constexpr (std::is_floating_point_v<T>) {
+         return c.fixed<T>();
+      }
+      else {
+         const auto v = c.varint();
+         if constexpr (std::same_as<T, bool>) {
+            return v != 0;
+         }
+         else if constexpr (std::is_signed_v<T>) {
+            return sizeof(T) <= 4 ? T(pb_wire::unzigzag32(uint32_t(v))) : T(pb_wire::unzigzag64(v));
+         }
+         else {
+            return T(v);
+         }
+      }
+   }
+
+   template <scalar T>
+   constexpr bool is_zero(T v)
+   {
+      if constexpr (std::same_as<T, float>) {
+         return std::bit_cast<uint32_t>(v) == 0; // keeps -0.0
+      }
+      else if constexpr (std::same_as<T, double>) {
+         return std::bit_cast<uint64_t>(v) == 0;
+      }
+      else {
+         return v == T{};
+      }
+   }
+
+   // The wire type only occupies the low three bits, so it does not change the size of a tag
+   constexpr size_t tag_size(uint32_t number) { return pb_wire::varint_size(pb_wire::make_tag(number, {})); }
+
+   template <class E, class A>
+   size_t packed_size(const std::vector<E, A>& v)
+   {
+      if constexpr (std::is_floating_point_v<E>) {
+         return v.size() * sizeof(E);
+      }
+      else {
+         size_t n = 0;
+         for (const auto e : v) {
+            n += scalar_size(E(e));
+         }
+         return n;
+      }
+   }
+
+   template <has_fields T>
+   size_t message_size(const T& value);
+
+   template <class T, size_t N>
+   size_t message_size(const std::array<T, N>& value);
+
+   // Size of one length-delimited string or message, without its tag
+   template <class M>
+   size_t payload_size(const M& member)
+   {
+      const auto n = [&] {
+         if constexpr (char_string<M>) {
+            return member.size();
+         }
+         else {
+            return message_size(member);
+         }
+      }();
+      return pb_wire::varint_size(n) + n;
+   }
+
+   template <class M>
+   size_t field_size(uint32_t number, const M& member)
+   {
+      if constexpr (scalar<M>) {
+         return is_zero(member) ? 0 : tag_size(number) + scalar_size(member);
+      }
+      else if constexpr (char_string<M>) {
+         return member.empty() ? 0 : tag_size(number) + payload_size(member);
+      }
+      else if constexpr (is_vector<M>::value) {
+         if (member.empty()) {
+            return 0;
+         }
+         if constexpr (scalar<typename M::value_type>) {
+            const auto n = packed_size(member);
+            return tag_size(number) + pb_wire::varint_size(n) + n;
+         }
+         else {
+            size_t n = 0;
+            for (const auto& e : member) {
+               n += tag_size(number) + payload_size(e);
+            }
+            return n;
+         }
+      }
+      else {
+         return tag_size(number) + payload_size(member);
+      }
+   }
+
+   template <has_fields T>
+   size_t message_size(const T& value)
+   {
+      size_t n = 0;
+      for_each_field(value, [&](const auto& member, std::string_view, uint32_t number) {
+         n += field_size(number, member);
+      });
+      return n;
+   }
+
+   template <class T, size_t N>
+   size_t message_size(const std::array<T, N>& value)
+   {
+      size_t n = 0;
+      for (size_t i = 0; i < N; ++i) {
+         n += field_size(uint32_t(i + 1), value[i]);
+      }
+      return n;
+   }
+
+   template <has_fields T>
+   char* write_message(char* out, const T& value);
+
+   template <class T, size_t N>
+   char* write_message(char* out, const std::array<T, N>& value);
+
+   // One length-delimited string or message, without its tag
+   template <class M>
+   char* write_payload(char* out, const M& member)
+   {
+      if constexpr (char_string<M>) {
+         out = pb_wire::put_varint(out, member.size());
+         std::memcpy(out, member.data(), member.size());
+         return out + member.size();
+      }
+      else {
+         out = pb_wire::put_varint(out, message_size(member));
+         return write_message(out, member);
+      }
+   }
+
+   template <class M>
+   char* write_field(char* out, uint32_t number, const M& member)
+   {
+      using pb_wire::wire_type;
+      if constexpr (scalar<M>) {
+         if (is_zero(member)) {
+            return out;
+         }
+         out = pb_wire::put_varint(out, pb_wire::make_tag(number, scalar_wire_type<M>()));
+         return put_scalar(out, member);
+      }
+      else if constexpr (char_string<M>) {
+         if (member.empty()) {
+            return out;
+         }
+         out = pb_wire::put_varint(out, pb_wire::make_tag(number, wire_type::len));
+         return write_payload(out, member);
+      }
+      else if constexpr (is_vector<M>::value) {
+         using E = typename M::value_type;
+         if (member.empty()) {
+            return out;
+         }
+         if constexpr (scalar<E>) {
+            out = pb_wire::put_varint(out, pb_wire::make_tag(number, wire_type::len));
+            out = pb_wire::put_varint(out, packed_size(member));
+            if constexpr (std::is_floating_point_v<E>) {
+               std::memcpy(out, member.data(), member.size() * sizeof(E));
+               return out + member.size() * sizeof(E);
+            }
+            else {
+               for (const auto e : member) {
+                  out = put_scalar(out, E(e));
+               }
+               return out;
+            }
+         }
+         else {
+            for (const auto& e : member) {
+               out = pb_wire::put_varint(out, pb_wire::make_tag(number, wire_type::len));
+               out = write_payload(out, e);
+            }
+            return out;
+         }
+      }
+      else {
+         out = pb_wire::put_varint(out, pb_wire::make_tag(number, wire_type::len));
+         return write_payload(out, member);
+      }
+   }
+
+   template <has_fields T>
+   char* write_message(char* out, const T& value)
+   {
+      for_each_field(value, [&](const auto& member, std::string_view, uint32_t number) {
+         out = write_field(out, number, member);
+      });
+      return out;
+   }
+
+   template <class T, size_t N>
+   char* write_message(char* out, const std::array<T, N>& value)
+   {
+      for (size_t i = 0; i < N; ++i) {
+         out = write_field(out, uint32_t(i + 1), value[i]);
+      }
+      return out;
+   }
+
+   template <has_fields T>
+   bool read_message(pb_wire::cursor& c, T& value);
+
+   template <class T, size_t N>
+   bool read_message(pb_wire::cursor& c, std::array<T, N>& value);
+
+   // Stores element `count` of a repeated field, reusing an existing element when there is one
+   template <class E, class A>
+   E& next_element(std::vector<E, A>& v, size_t& count)
+   {
+      if (count == v.size()) {
+         v.emplace_back();
+      }
+      return v[count++];
+   }
+
+   // Reads one occurrence of a field. `count` tracks occurrences (elements for vectors) within the current message.
+   template <class M>
+   void read_field(pb_wire::cursor& c, pb_wire::wire_type type, M& member, size_t& count)
+   {
+      using pb_wire::wire_type;
+      if constexpr (scalar<M>) {
+         member = get_scalar<M>(c, type);
+         count = 1;
+      }
+      else if constexpr (char_string<M>) {
+         if (type != wire_type::len) {
+            c.fail();
+            return;
+         }
+         const auto s = c.len();
+         member.assign(s.data(), s.size());
+         count = 1;
+      }
+      else if constexpr (is_vector<M>::value) {
+         using E = typename M::value_type;
+         if constexpr (scalar<E>) {
+            if (type != wire_type::len) {
+               next_element(member, count) = get_scalar<E>(c, type); // unpacked element
+               return;
+            }
+            const auto payload = c.len();
+            if constexpr (std::is_floating_point_v<E>) {
+               if (payload.size() % sizeof(E)) {
+                  c.fail();
+                  return;
+               }
+               const auto n = payload.size() / sizeof(E);
+               member.resize(count + n);
+               std::memcpy(member.data() + count, payload.data(), payload.size());
+               count += n;
+            }
+            else {
+               pb_wire::cursor sub{payload};
+               while (!sub.done() && sub.ok) {
+                  next_element(member, count) = get_scalar<E>(sub, scalar_wire_type<E>());
+               }
+               if (!sub.ok) {
+                  c.fail();
+               }
+            }
+         }
+         else {
+            size_t element_count{};
+            read_field(c, type, next_element(member, count), element_count);
+         }
+      }
+      else {
+         if (type != wire_type::len) {
+            c.fail();
+            return;
+         }
+         pb_wire::cursor sub{c.len()};
+         if (!pb_direct::read_message(sub, member)) {
+            c.fail();
+         }
+         count = 1;
+      }
+   }
+
+   // Drops vector elements left over from a previous decode and resets fields missing from the input
+   template <class M>
+   void finish_field(M& member, size_t count)
+   {
+      if constexpr (is_vector<M>::value) {
+         member.resize(count);
+      }
+      else if (count == 0) {
+         if constexpr (scalar<M>) {
+            member = M{};
+         }
+         else if constexpr (char_string<M>) {
+            member.clear();
+         }
+         else {
+            pb_wire::cursor empty{};
+            pb_direct::read_message(empty, member);
+         }
+      }
+   }
+
+   template <has_fields T>
+   bool read_message(pb_wire::cursor& c, T& value)
+   {
+      std::array<size_t, field_count<T>> counts{}; // by position in the table, since numbers may have gaps
+      uint32_t number{};
+      pb_wire::wire_type type{};
+      while (c.tag(number, type)) {
+         bool found = false;
+         size_t index = 0;
+         for_each_field(value, [&](auto& member, std::string_view, uint32_t field_number) {
+            if (!found && field_number == number) {
+               found = true;
+               read_field(c, type, member, counts[index]);
+            }
+            ++index;
+         });
+         if (!found) {
+            c.skip(type);
+         }
+      }
+      size_t index = 0;
+      for_each_field(value, [&](auto& member, auto&&...) { finish_field(member, counts[index++]); });
+      return c.ok;
+   }
+
+   template <class T, size_t N>
+   bool read_message(pb_wire::cursor& c, std::array<T, N>& value)
+   {
+      std::array<size_t, N> counts{};
+      uint32_t number{};
+      pb_wire::wire_type type{};
+      while (c.tag(number, type)) {
+         if (number <= N) {
+            read_field(c, type, value[number - 1], counts[number - 1]);
+         }
+         else {
+            c.skip(type);
+         }
+      }
+      for (size_t i = 0; i < N; ++i) {
+         finish_field(value[i], counts[i]);
+      }
+      return c.ok;
+   }
+
+   // Replaces the contents of `buffer` (std::string or a vector of char/std::byte) with the encoded message
+   template <has_fields T, class Buffer>
+   void encode(const T& value, Buffer& buffer)
+   {
+      buffer.resize(message_size(value));
+      write_message(reinterpret_cast<char*>(buffer.data()), value);
+   }
+
+   template <has_fields T>
+   bool decode(std::string_view in, T& value)
+   {
+      pb_wire::cursor c{in};
+      return pb_direct::read_message(c, value);
+   }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+
+// Protocol Buffers wire format primitives (https://protobuf.dev/programming-guides/encoding/): varints, zig-zag,
+// tags and length-delimited fields, for reading and writing.
+
+namespace pb_wire
+{
+   enum struct wire_type : uint8_t { varint = 0, fixed64 = 1, len = 2, fixed32 = 5 };
+
+   constexpr uint32_t zigzag32(int32_t v) { return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+   constexpr uint64_t zigzag64(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+   constexpr int32_t unzigzag32(uint32_t v) { return int32_t(v >> 1) ^ -int32_t(v & 1); }
+   constexpr int64_t unzigzag64(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+   constexpr size_t varint_size(uint64_t v)
+   {
+      size_t n = 1;
+      while (v >= 0x80) {
+         v >>= 7;
+         ++n;
+      }
+      return n;
+   }
+
+   constexpr uint64_t make_tag(uint32_t field, wire_type type) { return uint64_t(field) << 3 | uint64_t(type); }
+
+   // Writers for a buffer sized in advance: each returns the position after what it wrote
+   inline char* put_varint(char* out, uint64_t v)
+   {
+      while (v >= 0x80) {
+         *out++ = char(v | 0x80);
+         v >>= 7;
+      }
+      *out++ = char(v);
+      return out;
+   }
+
+   template <class T>
+   char* put_fixed(char* out, T value)
+   {
+      static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+      std::memcpy(out, &value, sizeof(T)); // little endian
+      return out + sizeof(T);
+   }
+
+   struct cursor
+   {
+      const char* it{};
+      const char* end{};
+      bool ok = true;
+
+      cursor() = default;
+      cursor(const char* data, size_t size) : it(data), end(data + size) {}
+      explicit cursor(std::string_view buffer) : cursor(buffer.data(), buffer.size()) {}
+
+      bool fail()
+      {
+         ok = false;
+         it = end;
+         return false;
+      }
+
+      bool done() const { return it >= end; }
+
+      uint64_t varint()
+      {
+         uint64_t value{};
+         for (int shift = 0; shift < 64; shift += 7) {
+            if (it >= end) {
+               fail();
+               return 0;
+            }
+            const auto byte = uint8_t(*it++);
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+               return value;
+            }
+         }
+         fail();
+         return 0;
+      }
+
+      // Reads the next tag. Returns false at the end of the message or on error.
+      bool tag(uint32_t& field, wire_type& type)
+      {
+         if (done()) {
+            return false;
+         }
+         const auto key = varint();
+         field = uint32_t(key >> 3);
+         type = wire_type(key & 0b111);
+         if (ok && field == 0) {
+            return fail();
+         }
+         return ok;
+      }
+
+      template <class T>
+      T fixed()
+      {
+         static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+         if (size_t(end - it) < sizeof(T)) {
+            fail();
+            return T{};
+         }
+         T value;
+         std::memcpy(&value, it, sizeof(T)); // little endian
+         it += sizeof(T);
+         return value;
+      }
+
+      std::string_view len()
+      {
+         const auto n = varint();
+         if (!ok || n > uint64_t(end - it)) {
+            fail();
+            return {};
+         }
+         const std::string_view payload{it, size_t(n)};
+         it += n;
+         return payload;
+      }
+
+      bool skip(wire_type type)
+      {
+         switch (type) {
+         case wire_type::varint:
+            varint();
+            return ok;
+         case wire_type::fixed64:
+            fixed<uint64_t>();
+            return ok;
+         case wire_type::len:
+            len();
+            return ok;
+         case wire_type::fixed32:
+            fixed<uint32_t>();
+            return ok;
+         default:
+            return fail(); // groups are not supported
+         }
+      }
+   };
+
+   // Follows field numbers through nested messages, skipping every other field, and leaves the cursor at the value
+   // of the first occurrence of the last field, whose wire type is stored in `type`. The cursor is narrowed to the
+   // enclosing message on the way. Returns false when a field is missing or the input is malformed.
+   inline bool find(cursor& c, std::initializer_list<uint32_t> path, wire_type& type)
+   {
+      auto remaining = path.size();
+      for (const auto number : path) {
+         uint32_t field{};
+         bool found = false;
+         while (!found && c.tag(field, type)) {
+            found = field == number;
+            if (!found) {
+               c.skip(type);
+            }
+         }
+         if (!found) {
+            return false;
+         }
+         if (--remaining) {
+            if (type != wire_type::len) {
+               return c.fail();
+            }
+            const auto payload = c.len();
+            if (!c.ok) {
+               return false;
+            }
+            c = cursor{payload};
+         }
+      }
+      return c.ok;
+   }
+
+   // Walks the tags and lengths of one message without interpreting a field. Length-delimited fields are not
+   // entered: without a schema they may as well be strings or packed arrays as nested messages.
+   inline bool validate(std::string_view message)
+   {
+      cursor c{message};
+      uint32_t field{};
+      wire_type type{};
+      while (c.tag(field, type)) {
+         if (!c.skip(type)) {
+            return false;
+         }
+      }
+      return c.ok;
+   }
+}
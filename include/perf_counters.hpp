@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+// Hardware performance counters via Linux perf_event_open. Each event is opened independently so that any subset
+// the kernel/PMU refuses (containers, VMs, perf_event_paranoid) simply stays empty and timing still works.
+
+struct perf_counts
+{
+   std::optional<double> cycles{};
+   std::optional<double> instructions{};
+   std::optional<double> branch_misses{};
+   std::optional<double> l1d_misses{};
+   std::optional<double> llc_misses{};
+   std::optional<double> dtlb_misses{};
+
+   bool empty() const { return !cycles && !instructions && !branch_misses && !l1d_misses && !llc_misses && !dtlb_misses; }
+};
+
+class perf_counters
+{
+  public:
+   static constexpr size_t event_count = 6;
+
+   perf_counters()
+   {
+#ifdef __linux__
+      constexpr auto cache_event = [](uint64_t cache, uint64_t op, uint64_t result) {
+         return cache | (op << 8) | (result << 16);
+      };
+      const std::array<std::pair<uint32_t, uint64_t>, event_count> events{{
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+         {PERF_TYPE_HW_CACHE,
+          cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+         {PERF_TYPE_HW_CACHE,
+          cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+         {PERF_TYPE_HW_CACHE,
+          cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      }};
+
+      for (size_t i = 0; i < event_count; ++i) {
+         perf_event_attr attr{};
+         std::memset(&attr, 0, sizeof(attr));
+         attr.size = sizeof(attr);
+         attr.type = events[i].first;
+         attr.config = events[i].second;
+         attr.disabled = 1;
+         attr.exclude_kernel = 1;
+         attr.exclude_hv = 1;
+         attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+         fds[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      }
+#endif
+   }
+
+   perf_counters(const perf_counters&) = delete;
+   perf_counters& operator=(const perf_counters&) = delete;
+
+   ~perf_counters()
+   {
+#ifdef __linux__
+      for (auto fd : fds) {
+         if (fd >= 0) {
+            close(fd);
+         }
+      }
+#endif
+   }
+
+   bool available() const
+   {
+      for (auto fd : fds) {
+         if (fd >= 0) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   void start()
+   {
+#ifdef __linux__
+      for (auto fd : fds) {
+         if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+         }
+      }
+#endif
+   }
+
+   perf_counts stop()
+   {
+      std::array<std::optional<double>, event_count> values{};
+#ifdef __linux__
+      for (auto fd : fds) {
+         if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+         }
+      }
+      for (size_t i = 0; i < event_count; ++i) {
+         // value, time enabled, time running: scale up when the PMU multiplexed this event
+         uint64_t data[3]{};
+         if (fds[i] >= 0 && read(fds[i], data, sizeof(data)) == ssize_t(sizeof(data)) && data[2] > 0) {
+            values[i] = double(data[0]) * double(data[1]) / double(data[2]);
+         }
+      }
+#endif
+      return {values[0], values[1], values[2], values[3], values[4], values[5]};
+   }
+
+  private:
+   std::array<int, event_count> fds{-1, -1, -1, -1, -1, -1};
+};
+
+// Probed once: whether this process can open any hardware counter at all
+inline bool perf_counters_available()
+{
+   static const bool available = perf_counters{}.available();
+   return available;
+}
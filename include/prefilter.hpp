@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Reversible pre-filters for numeric arrays, applied to the values before a codec encodes them and undone after it
+// decodes them. Neither filter changes the element count or width, so a filtered array is still a std::vector<T>.
+//
+// difference: replaces every element by its bit pattern minus (delta) or xor'ed with (xor_previous) the bit pattern
+// of the previous element, so slowly changing integers, timestamps and floats turn into runs of zero high bytes.
+// shuffle: transposes the array into byte planes (all first bytes, then all second bytes, ...) as Blosc does, which
+// groups those zero or repeated bytes together for a following entropy stage.
+
+namespace prefilter
+{
+   enum struct difference : uint8_t { none, delta, xor_previous };
+
+   struct pipeline
+   {
+      difference diff{};
+      bool shuffle{};
+
+      std::string name() const
+      {
+         std::string s = diff == difference::delta ? "delta" : diff == difference::xor_previous ? "xor" : "";
+         if (shuffle) {
+            s += s.empty() ? "shuffle" : " + shuffle";
+         }
+         return s.empty() ? "none" : s;
+      }
+   };
+
+   template <size_t Width>
+   using word_t = std::conditional_t<
+      Width == 1, uint8_t, std::conditional_t<Width == 2, uint16_t, std::conditional_t<Width == 4, uint32_t, uint64_t>>>;
+
+   // Each output element only depends on two input elements, so the loop vectorizes
+   template <class T, class Op>
+   void difference_encode(const T* in, T* out, size_t n, Op op)
+   {
+      using W = word_t<sizeof(T)>;
+      if (n == 0) {
+         return;
+      }
+      std::memcpy(out, in, sizeof(T)); // the first element is kept as is
+      for (size_t i = 1; i < n; ++i) {
+         W v, prev;
+         std::memcpy(&v, in + i, sizeof(T));
+         std::memcpy(&prev, in + i - 1, sizeof(T));
+         const W d = op(v, prev);
+         std::memcpy(out + i, &d, sizeof(T));
+      }
+   }
+
+   template <class T>
+   void difference_encode(difference diff, const T* in, T* out, size_t n)
+   {
+      using W = word_t<sizeof(T)>;
+      if (diff == difference::delta) {
+         difference_encode(in, out, n, [](W v, W prev) { return W(v - prev); });
+      }
+      else {
+         difference_encode(in, out, n, [](W v, W prev) { return W(v ^ prev); });
+      }
+   }
+
+   template <class T>
+   void difference_decode(difference diff, const T* in, T* out, size_t n)
+   {
+      using W = word_t<sizeof(T)>;
+      W prev{};
+      for (size_t i = 0; i < n; ++i) {
+         W d;
+         std::memcpy(&d, in + i, sizeof(T));
+         prev = diff == difference::delta ? W(prev + d) : W(prev ^ d);
+         std::memcpy(out + i, &prev, sizeof(T));
+      }
+   }
+
+#if defined(__SSE2__)
+   // One interleaving round over a 128 byte block held in 8 registers. Viewing a byte's position in the block as
+   // 7 address bits (4 for the byte within its register, then 3 for the register), a round rotates the address left
+   // by one bit. Shuffling elements of 2^w bytes moves the w byte-index bits above the element-index bits, which
+   // takes 7 - w rounds; unshuffling takes w rounds.
+   inline void interleave_round(__m128i r[8])
+   {
+      __m128i t[8];
+      for (size_t k = 0; k < 4; ++k) {
+         t[2 * k] = _mm_unpacklo_epi8(r[k], r[k + 4]);
+         t[2 * k + 1] = _mm_unpackhi_epi8(r[k], r[k + 4]);
+      }
+      for (size_t k = 0; k < 8; ++k) {
+         r[k] = t[k];
+      }
+   }
+
+   constexpr size_t log2_width(size_t width) { return width == 8 ? 3 : width == 4 ? 2 : width == 2 ? 1 : 0; }
+#endif
+
+   // In-register byte matrix transposes (SWAR) for the tail after the SSE2 blocks, or everything without SSE2: rows
+   // are little-endian words, so afterwards word b holds byte b of every input word. Each is its own inverse.
+   inline void transpose_8x8(uint64_t m[8])
+   {
+      for (size_t r = 0; r < 4; ++r) {
+         const auto t = ((m[r] >> 32) ^ m[r + 4]) & 0x00000000FFFFFFFFull;
+         m[r] ^= t << 32;
+         m[r + 4] ^= t;
+      }
+      for (size_t r : {0, 1, 4, 5}) {
+         const auto t = ((m[r] >> 16) ^ m[r + 2]) & 0x0000FFFF0000FFFFull;
+         m[r] ^= t << 16;
+         m[r + 2] ^= t;
+      }
+      for (size_t r : {0, 2, 4, 6}) {
+         const auto t = ((m[r] >> 8) ^ m[r + 1]) & 0x00FF00FF00FF00FFull;
+         m[r] ^= t << 8;
+         m[r + 1] ^= t;
+      }
+   }
+
+   inline void transpose_4x4(uint32_t m[4])
+   {
+      for (size_t r : {0, 1}) {
+         const auto t = ((m[r] >> 16) ^ m[r + 2]) & 0x0000FFFFu;
+         m[r] ^= t << 16;
+         m[r + 2] ^= t;
+      }
+      for (size_t r : {0, 2}) {
+         const auto t = ((m[r] >> 8) ^ m[r + 1]) & 0x00FF00FFu;
+         m[r] ^= t << 8;
+         m[r + 1] ^= t;
+      }
+   }
+
+   // Byte planes of n elements of Width bytes: out[b * n + i] = in[i * Width + b]
+   template <size_t Width>
+   void shuffle(const std::byte* in, std::byte* out, size_t n)
+   {
+      size_t i = 0;
+#if defined(__SSE2__)
+      if constexpr (Width > 1) {
+         constexpr size_t block = 128 / Width; // elements per 8 registers
+         constexpr size_t per_plane = 8 / Width; // registers per byte plane
+         for (; i + block <= n; i += block) {
+            __m128i r[8];
+            for (size_t k = 0; k < 8; ++k) {
+               r[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * Width + 16 * k));
+            }
+            for (size_t round = 0; round < 7 - log2_width(Width); ++round) {
+               interleave_round(r);
+            }
+            for (size_t b = 0; b < Width; ++b) {
+               for (size_t q = 0; q < per_plane; ++q) {
+                  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + b * n + i + 16 * q), r[b * per_plane + q]);
+               }
+            }
+         }
+      }
+#endif
+      if constexpr (Width == 8 || Width == 4) {
+         using W = word_t<Width>;
+         for (; i + Width <= n; i += Width) {
+            W m[Width];
+            std::memcpy(m, in + i * Width, sizeof(m));
+            if constexpr (Width == 8) {
+               transpose_8x8(m);
+            }
+            else {
+               transpose_4x4(m);
+            }
+            for (size_t b = 0; b < Width; ++b) {
+               std::memcpy(out + b * n + i, &m[b], Width);
+            }
+         }
+      }
+      for (; i < n; ++i) {
+         for (size_t b = 0; b < Width; ++b) {
+            out[b * n + i] = in[i * Width + b];
+         }
+      }
+   }
+
+   template <size_t Width>
+   void unshuffle(const std::byte* in, std::byte* out, size_t n)
+   {
+      size_t i = 0;
+#if defined(__SSE2__)
+      if constexpr (Width > 1) {
+         constexpr size_t block = 128 / Width;
+         constexpr size_t per_plane = 8 / Width;
+         for (; i + block <= n; i += block) {
+            __m128i r[8];
+            for (size_t b = 0; b < Width; ++b) {
+               for (size_t q = 0; q < per_plane; ++q) {
+                  r[b * per_plane + q] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + b * n + i + 16 * q));
+               }
+            }
+            for (size_t round = 0; round < log2_width(Width); ++round) {
+               interleave_round(r);
+            }
+            for (size_t k = 0; k < 8; ++k) {
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * Width + 16 * k), r[k]);
+            }
+         }
+      }
+#endif
+      if constexpr (Width == 8 || Width == 4) {
+         using W = word_t<Width>;
+         for (; i + Width <= n; i += Width) {
+            W m[Width];
+            for (size_t b = 0; b < Width; ++b) {
+               std::memcpy(&m[b], in + b * n + i, Width);
+            }
+            if constexpr (Width == 8) {
+               transpose_8x8(m);
+            }
+            else {
+               transpose_4x4(m);
+            }
+            std::memcpy(out + i * Width, m, sizeof(m));
+         }
+      }
+      for (; i < n; ++i) {
+         for (size_t b = 0; b < Width; ++b) {
+            out[i * Width + b] = in[b * n + i];
+         }
+      }
+   }
+
+   // Filters `in` into `out` (resized to match); `scratch` holds the intermediate array when both stages run
+   template <class T>
+   void encode(const pipeline& p, std::span<const T> in, std::vector<T>& out, std::vector<T>& scratch)
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto n = in.size();
+      out.resize(n);
+      if (!p.shuffle) {
+         if (p.diff == difference::none) {
+            std::memcpy(out.data(), in.data(), n * sizeof(T));
+         }
+         else {
+            difference_encode(p.diff, in.data(), out.data(), n);
+         }
+         return;
+      }
+      const T* src = in.data();
+      if (p.diff != difference::none) {
+         scratch.resize(n);
+         difference_encode(p.diff, in.data(), scratch.data(), n);
+         src = scratch.data();
+      }
+      shuffle<sizeof(T)>(reinterpret_cast<const std::byte*>(src), reinterpret_cast<std::byte*>(out.data()), n);
+   }
+
+   template <class T>
+   void decode(const pipeline& p, std::span<const T> in, std::vector<T>& out, std::vector<T>& scratch)
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto n = in.size();
+      out.resize(n);
+      if (!p.shuffle) {
+         if (p.diff == difference::none) {
+            std::memcpy(out.data(), in.data(), n * sizeof(T));
+         }
+         else {
+            difference_decode(p.diff, in.data(), out.data(), n);
+         }
+         return;
+      }
+      T* dst = out.data();
+      if (p.diff != difference::none) {
+         scratch.resize(n);
+         dst = scratch.data();
+      }
+      unshuffle<sizeof(T)>(reinterpret_cast<const std::byte*>(in.data()), reinterpret_cast<std::byte*>(dst), n);
+      if (p.diff != difference::none) {
+         difference_decode(p.diff, scratch.data(), out.data(), n);
+      }
+   }
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "fields.hpp"
+
+// Minimal hand-written binary codec: the members of each fields<T> table in declaration order, trivially copyable
+// values (numbers, bools, std::array of numbers) as their native in-memory bytes, strings and vectors as a uint32
+// element count followed by their elements, with vectors of trivially copyable elements copied in one block. No keys,
+// tags or type information and no byte order conversion, so it only round-trips on the same kind of machine. It is
+// the floor a self-describing format is measured against.
+
+namespace raw_codec
+{
+   template <class T>
+   struct is_vector : std::false_type
+   {};
+
+   template <class T, class A>
+   struct is_vector<std::vector<T, A>> : std::true_type
+   {};
+
+   template <class T>
+   concept trivial = std::is_trivially_copyable_v<T> && !has_fields<T>;
+
+   template <class T>
+   size_t encoded_size(const T& value)
+   {
+      if constexpr (trivial<T>) {
+         return sizeof(T);
+      }
+      else if constexpr (char_string<T>) {
+         return sizeof(uint32_t) + value.size();
+      }
+      else if constexpr (is_vector<T>::value) {
+         using E = typename T::value_type;
+         if constexpr (trivial<E>) {
+            return sizeof(uint32_t) + value.size() * sizeof(E);
+         }
+         else {
+            size_t n = sizeof(uint32_t);
+            for (const auto& e : value) {
+               n += encoded_size(e);
+            }
+            return n;
+         }
+      }
+      else {
+         static_assert(has_fields<T>, "raw_codec: unsupported type");
+         size_t n = 0;
+         for_each_field(value, [&](const auto& member, auto&&...) { n += encoded_size(member); });
+         return n;
+      }
+   }
+
+   inline char* put_count(char* out, size_t n)
+   {
+      const auto count = uint32_t(n);
+      std::memcpy(out, &count, sizeof(count));
+      return out + sizeof(count);
+   }
+
+   template <class T>
+   char* write(char* out, const T& value)
+   {
+      if constexpr (trivial<T>) {
+         std::memcpy(out, &value, sizeof(T));
+         return out + sizeof(T);
+      }
+      else if constexpr (char_string<T>) {
+         out = put_count(out, value.size());
+         std::memcpy(out, value.data(), value.size());
+         return out + value.size();
+      }
+      else if constexpr (is_vector<T>::value) {
+         using E = typename T::value_type;
+         out = put_count(out, value.size());
+         if constexpr (trivial<E>) {
+            if (!value.empty()) {
+               std::memcpy(out, value.data(), value.size() * sizeof(E));
+            }
+            return out + value.size() * sizeof(E);
+         }
+         else {
+            for (const auto& e : value) {
+               out = write(out, e);
+            }
+            return out;
+         }
+      }
+      else {
+         for_each_field(value, [&](const auto& member, auto&&...) { out = write(out, member); });
+         return out;
+      }
+   }
+
+   // Bounds-checked reader over the input; any overrun fails the whole decode
+   struct cursor
+   {
+      const char* it{};
+      const char* end{};
+
+      bool take(void* dst, size_t n)
+      {
+         if (size_t(end - it) < n) {
+            return false;
+         }
+         if (n) {
+            std::memcpy(dst, it, n);
+         }
+         it += n;
+         return true;
+      }
+
+      bool count(size_t& n)
+      {
+         uint32_t c{};
+         if (!take(&c, sizeof(c))) {
+            return false;
+         }
+         n = c;
+         return true;
+      }
+   };
+
+   template <class T>
+   bool read(cursor& c, T& value)
+   {
+      if constexpr (trivial<T>) {
+         return c.take(&value, sizeof(T));
+      }
+      else if constexpr (char_string<T>) {
+         size_t n{};
+         if (!c.count(n) || size_t(c.end - c.it) < n) {
+            return false;
+         }
+         value.assign(c.it, n);
+         c.it += n;
+         return true;
+      }
+      else if constexpr (is_vector<T>::value) {
+         using E = typename T::value_type;
+         size_t n{};
+         if (!c.count(n)) {
+            return false;
+         }
+         if constexpr (trivial<E>) {
+            if (size_t(c.end - c.it) / sizeof(E) < n) {
+               return false;
+            }
+            value.resize(n);
+            return c.take(value.data(), n * sizeof(E));
+         }
+         else {
+            if (size_t(c.end - c.it) < n) {
+               return false; // every element takes at least one byte
+            }
+            value.resize(n);
+            for (auto& e : value) {
+               if (!read(c, e)) {
+                  return false;
+               }
+            }
+            return true;
+         }
+      }
+      else {
+         bool ok = true;
+         for_each_field(value, [&](auto& member, auto&&...) { ok = ok && read(c, member); });
+         return ok;
+      }
+   }
+
+   // Replaces out with the encoding of value, sized in one pass before writing
+   template <class T>
+   void encode(const T& value, std::string& out)
+   {
+      out.resize(encoded_size(value));
+      write(out.data(), value);
+   }
+
+   // Decodes into value, reusing the capacity of its strings and vectors
+   template <class T>
+   bool decode(std::string_view in, T& value)
+   {
+      cursor c{in.data(), in.data() + in.size()};
+      return read(c, value) && c.it == c.end;
+   }
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Append-only log of length-prefixed records: each record is a 4 byte little-endian payload length followed by the
+// payload. Written with buffered write(2) calls and read back either with read(2) or through mmap(2). Errors are
+// sticky: after a failed syscall or a truncated record ok() is false and no further records are produced.
+
+namespace record_log
+{
+   constexpr size_t prefix_size = 4;
+   constexpr size_t default_buffer_size = size_t(1) << 20;
+
+   inline void put_prefix(char* out, uint32_t size)
+   {
+      for (size_t i = 0; i < prefix_size; ++i) {
+         out[i] = char(size >> (8 * i));
+      }
+   }
+
+   inline uint32_t get_prefix(const char* in)
+   {
+      uint32_t size{};
+      for (size_t i = 0; i < prefix_size; ++i) {
+         size |= uint32_t(uint8_t(in[i])) << (8 * i);
+      }
+      return size;
+   }
+
+   class writer
+   {
+     public:
+      explicit writer(const std::string& path, size_t buffer_size = default_buffer_size)
+         : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), buffer(buffer_size)
+      {
+         valid = fd >= 0;
+      }
+
+      writer(const writer&) = delete;
+      writer& operator=(const writer&) = delete;
+
+      ~writer() { close(); }
+
+      bool ok() const { return valid; }
+      uint64_t bytes_written() const { return written; }
+
+      bool append(std::string_view record)
+      {
+         if (!valid) {
+            return false;
+         }
+         char prefix[prefix_size];
+         put_prefix(prefix, uint32_t(record.size()));
+         return put({prefix, prefix_size}) && put(record);
+      }
+
+      bool flush()
+      {
+         const char* it = buffer.data();
+         while (valid && used > 0) {
+            const auto n = ::write(fd, it, used);
+            if (n < 0 && errno == EINTR) {
+               continue;
+            }
+            if (n <= 0) {
+               valid = false;
+               break;
+            }
+            it += n;
+            used -= size_t(n);
+            written += uint64_t(n);
+         }
+         used = 0;
+         return valid;
+      }
+
+      // Flushes the buffer and closes the file; the data may still be in the page cache only
+      bool close()
+      {
+         if (fd >= 0) {
+            flush();
+            if (::close(fd) != 0) {
+               valid = false;
+            }
+            fd = -1;
+         }
+         return valid;
+      }
+
+     private:
+      bool put(std::string_view bytes)
+      {
+         while (!bytes.empty() && valid) {
+            if (used == buffer.size() && !flush()) {
+               return false;
+            }
+            const auto n = (std::min)(bytes.size(), buffer.size() - used);
+            std::memcpy(buffer.data() + used, bytes.data(), n);
+            used += n;
+            bytes.remove_prefix(n);
+         }
+         return valid;
+      }
+
+      int fd = -1;
+      bool valid = false;
+      std::vector<char> buffer{};
+      size_t used{};
+      uint64_t written{};
+   };
+
+   // Reads records through a buffer refilled with read(2). A record view stays valid until the next call to next().
+   class reader
+   {
+     public:
+      explicit reader(const std::string& path, size_t buffer_size = default_buffer_size)
+         : fd(::open(path.c_str(), O_RDONLY)), buffer(buffer_size)
+      {
+         valid = fd >= 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+         if (valid) {
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+         }
+#endif
+      }
+
+      reader(const reader&) = delete;
+      reader& operator=(const reader&) = delete;
+
+      ~reader()
+      {
+         if (fd >= 0) {
+            ::close(fd);
+         }
+      }
+
+      bool ok() const { return valid; }
+
+      // Returns false at the end of the log or on error
+      bool next(std::string_view& record)
+      {
+         if (!fill(prefix_size)) {
+            return false;
+         }
+         const auto size = get_prefix(buffer.data() + begin);
+         if (!fill(prefix_size + size)) {
+            return false; // fill() flags a prefix without its payload as a truncated log
+         }
+         record = {buffer.data() + begin + prefix_size, size};
+         begin += prefix_size + size;
+         return true;
+      }
+
+     private:
+      // Makes at least n bytes available from begin, returning false at a clean end of file
+      bool fill(size_t n)
+      {
+         if (end - begin >= n) {
+            return true;
+         }
+         if (!valid) {
+            return false;
+         }
+         std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+         end -= begin;
+         begin = 0;
+         if (buffer.size() < n) {
+            buffer.resize(n); // record larger than the buffer
+         }
+         while (end < n) {
+            const auto r = ::read(fd, buffer.data() + end, buffer.size() - end);
+            if (r < 0 && errno == EINTR) {
+               continue;
+            }
+            if (r < 0) {
+               valid = false;
+               return false;
+            }
+            if (r == 0) {
+               if (end != 0) {
+                  valid = false; // trailing partial record
+               }
+               return false;
+            }
+            end += size_t(r);
+         }
+         return true;
+      }
+
+      int fd = -1;
+      bool valid = false;
+      std::vector<char> buffer{};
+      size_t begin{};
+      size_t end{};
+   };
+
+   // Maps the whole log read-only; record views point into the mapping and stay valid for its lifetime
+   class mapped_reader
+   {
+     public:
+      explicit mapped_reader(const std::string& path)
+      {
+         const int fd = ::open(path.c_str(), O_RDONLY);
+         struct stat st{};
+         if (fd < 0 || ::fstat(fd, &st) != 0) {
+            if (fd >= 0) {
+               ::close(fd);
+            }
+            return;
+         }
+         size = size_t(st.st_size);
+         if (size > 0) {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+               ::close(fd);
+               return;
+            }
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(p);
+         }
+         ::close(fd); // the mapping keeps the file referenced
+         valid = true;
+      }
+
+      mapped_reader(const mapped_reader&) = delete;
+      mapped_reader& operator=(const mapped_reader&) = delete;
+
+      ~mapped_reader()
+      {
+         if (data) {
+            ::munmap(const_cast<char*>(data), size);
+         }
+      }
+
+      bool ok() const { return valid; }
+
+      bool next(std::string_view& record)
+      {
+         if (!valid || offset == size) {
+            return false;
+         }
+         if (size - offset < prefix_size) {
+            valid = false;
+            return false;
+         }
+         const auto length = get_prefix(data + offset);
+         if (size - offset - prefix_size < length) {
+            valid = false;
+            return false;
+         }
+         record = {data + offset + prefix_size, length};
+         offset += prefix_size + length;
+         return true;
+      }
+
+     private:
+      const char* data{};
+      size_t size{};
+      size_t offset{};
+      bool valid = false;
+   };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Copy kernels that bound what any codec can reach on a given number of bytes: every encoder and decoder at least
+// reads its input and writes its output once. copy is a plain memcpy; stream_copy writes with non-temporal stores,
+// which bypass the cache and win once the destination no longer fits in it. Without SSE2 stream_copy is memcpy.
+
+namespace roofline
+{
+   // Keeps the compiler from dropping a copy whose destination is never read
+   inline void clobber(void* p)
+   {
+#if defined(__GNUC__)
+      asm volatile("" : : "r"(p) : "memory");
+#else
+      (void)p;
+#endif
+   }
+
+   inline void copy(void* dst, const void* src, size_t n)
+   {
+      std::memcpy(dst, src, n);
+      clobber(dst);
+   }
+
+   inline void stream_copy(void* dst, const void* src, size_t n)
+   {
+      auto* out = static_cast<char*>(dst);
+      auto* in = static_cast<const char*>(src);
+#if defined(__SSE2__)
+      const auto head = (16 - (reinterpret_cast<uintptr_t>(out) & 15)) & 15; // align the stores
+      if (n >= head + 64) {
+         std::memcpy(out, in, head);
+         out += head;
+         in += head;
+         n -= head;
+         for (; n >= 64; n -= 64, out += 64, in += 64) {
+            const auto* s = reinterpret_cast<const __m128i*>(in);
+            auto* d = reinterpret_cast<__m128i*>(out);
+            const auto a = _mm_loadu_si128(s);
+            const auto b = _mm_loadu_si128(s + 1);
+            const auto c = _mm_loadu_si128(s + 2);
+            const auto e = _mm_loadu_si128(s + 3);
+            _mm_stream_si128(d, a);
+            _mm_stream_si128(d + 1, b);
+            _mm_stream_si128(d + 2, c);
+            _mm_stream_si128(d + 3, e);
+         }
+         _mm_sfence(); // order the streaming stores before anything that reads the destination
+      }
+#endif
+      std::memcpy(out, in, n);
+      clobber(dst);
+   }
+}
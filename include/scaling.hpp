@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Multi-threaded scaling: N pinned threads, each with its own benchmark instance (and therefore its own buffers),
+// run the same write loop and then the same read loop in lockstep.
+
+struct scaling_point
+{
+   size_t threads{};
+   double write{}; // wall seconds for all threads to finish their write iterations
+   double read{}; // wall seconds for all threads to finish their read iterations
+   uint64_t size{};
+};
+
+// CPUs this process may run on, in ascending order
+inline std::vector<int> allowed_cpus()
+{
+   std::vector<int> cpus;
+#ifdef __linux__
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int i = 0; i < CPU_SETSIZE; ++i) {
+         if (CPU_ISSET(i, &set)) {
+            cpus.push_back(i);
+         }
+      }
+   }
+#endif
+   if (cpus.empty()) {
+      const auto n = (std::max)(std::thread::hardware_concurrency(), 1u);
+      for (unsigned i = 0; i < n; ++i) {
+         cpus.push_back(int(i));
+      }
+   }
+   return cpus;
+}
+
+inline void pin_current_thread([[maybe_unused]] int cpu)
+{
+#ifdef __linux__
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+   pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+// 1, 2, 4, ... up to max_threads, always including max_threads itself
+inline std::vector<size_t> thread_counts(size_t max_threads)
+{
+   std::vector<size_t> counts;
+   for (size_t n = 1; n < max_threads; n *= 2) {
+      counts.push_back(n);
+   }
+   counts.push_back((std::max)(max_threads, size_t(1)));
+   return counts;
+}
+
+// make() builds one bench, called on each pinned thread so its buffers are first touched locally
+template <class Make>
+scaling_point run_scaled(size_t threads, size_t iters, Make&& make)
+{
+   using clock = std::chrono::steady_clock;
+
+   const auto cpus = allowed_cpus();
+   const auto warmup = iters / 10;
+
+   // the calling thread joins every phase boundary to take timestamps
+   std::barrier sync(std::ptrdiff_t(threads + 1));
+   std::vector<uint64_t> sizes(threads);
+
+   std::vector<std::jthread> workers;
+   workers.reserve(threads);
+   for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+         pin_current_thread(cpus[t % cpus.size()]);
+         auto bench = make();
+         for (size_t i = 0; i < warmup; ++i) {
+            bench.write();
+            bench.read();
+         }
+         sizes[t] = bench.size();
+
+         sync.arrive_and_wait(); // start write
+         for (size_t i = 0; i < iters; ++i) {
+            bench.write();
+         }
+         sync.arrive_and_wait(); // write done, start read
+         for (size_t i = 0; i < iters; ++i) {
+            bench.read();
+         }
+         sync.arrive_and_wait(); // read done
+      });
+   }
+
+   sync.arrive_and_wait();
+   const auto t0 = clock::now();
+   sync.arrive_and_wait();
+   const auto t1 = clock::now();
+   sync.arrive_and_wait();
+   const auto t2 = clock::now();
+   workers.clear();
+
+   return {threads, std::chrono::duration<double>(t1 - t0).count(), std::chrono::duration<double>(t2 - t1).count(),
+           sizes.front()};
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#ifndef MSGPACK_NO_BOOST
+#define MSGPACK_NO_BOOST
+#endif
+#include "msgpack.hpp"
+
+#include "beve_reader.hpp"
+#include "fields.hpp"
+#include "pb_wire.hpp"
+
+// View mirrors of obj_t for zero-copy reads. Strings are std::string_view into the serialized buffer. Arrays are left
+// in the format's own wire representation (the Array parameter) instead of std::span<const T>, because none of the
+// formats guarantee the alignment a span over the buffer would need, and JSON, MessagePack and protobuf varints do
+// not store elements contiguously anyway. A view read therefore only locates fields and never copies payload bytes.
+
+template <class Array>
+struct fixed_object_view_t
+{
+   Array int_array{};
+   Array float_array{};
+   Array double_array{};
+};
+
+struct fixed_name_object_view_t
+{
+   std::string_view name0{};
+   std::string_view name1{};
+   std::string_view name2{};
+   std::string_view name3{};
+   std::string_view name4{};
+};
+
+template <class Array>
+struct nested_object_view_t
+{
+   Array v3s{};
+   std::string_view id{};
+};
+
+template <class Array>
+struct another_object_view_t
+{
+   std::string_view string{};
+   std::string_view another_string{};
+   bool boolean{};
+   nested_object_view_t<Array> nested_object{};
+};
+
+template <class Array>
+struct obj_view_t
+{
+   fixed_object_view_t<Array> fixed_object{};
+   fixed_name_object_view_t fixed_name_object{};
+   another_object_view_t<Array> another_object{};
+   std::vector<std::string_view> string_array{};
+   std::string_view string{};
+   double number{};
+   bool boolean{};
+   bool another_bool{};
+};
+
+template <class Array>
+struct fields<fixed_object_view_t<Array>>
+{
+   using T = fixed_object_view_t<Array>;
+   static constexpr auto value = std::tuple{field{"int_array", &T::int_array}, field{"float_array", &T::float_array},
+                                            field{"double_array", &T::double_array}};
+};
+
+template <>
+struct fields<fixed_name_object_view_t>
+{
+   using T = fixed_name_object_view_t;
+   static constexpr auto value = std::tuple{field{"name0", &T::name0}, field{"name1", &T::name1},
+                                            field{"name2", &T::name2}, field{"name3", &T::name3},
+                                            field{"name4", &T::name4}};
+};
+
+template <class Array>
+struct fields<nested_object_view_t<Array>>
+{
+   using T = nested_object_view_t<Array>;
+   static constexpr auto value = std::tuple{field{"v3s", &T::v3s}, field{"id", &T::id}};
+};
+
+template <class Array>
+struct fields<another_object_view_t<Array>>
+{
+   using T = another_object_view_t<Array>;
+   static constexpr auto value = std::tuple{field{"string", &T::string}, field{"another_string", &T::another_string},
+                                            field{"boolean", &T::boolean}, field{"nested_object", &T::nested_object}};
+};
+
+template <class Array>
+struct fields<obj_view_t<Array>>
+{
+   using T = obj_view_t<Array>;
+   static constexpr auto value =
+      std::tuple{field{"fixed_object", &T::fixed_object}, field{"fixed_name_object", &T::fixed_name_object},
+                 field{"another_object", &T::another_object}, field{"string_array", &T::string_array},
+                 field{"string", &T::string},           field{"number", &T::number},
+                 field{"boolean", &T::boolean},         field{"another_bool", &T::another_bool}};
+};
+
+// BEVE: arrays stay as the encoded bytes of the value
+namespace beve
+{
+   struct raw_value
+   {
+      std::string_view bytes{};
+   };
+
+   inline void read_view(cursor& c, std::string_view& value) { value = c.string(); }
+   inline void read_view(cursor& c, bool& value) { value = c.boolean(); }
+   inline void read_view(cursor& c, double& value) { value = c.number<double>(); }
+
+   inline void read_view(cursor& c, raw_value& value)
+   {
+      const auto* start = c.it;
+      c.skip();
+      value.bytes = {start, size_t(c.it - start)};
+   }
+
+   // Glaze writes std::vector<std::string> as a typed string array
+   inline void read_view(cursor& c, std::vector<std::string_view>& value)
+   {
+      const auto h = c.header();
+      if (header_type(h) != type::typed_array || header_kind(h) != number_kind::bool_or_string || !((h >> 5) & 1)) {
+         c.fail();
+         return;
+      }
+      value.resize(c.compressed());
+      for (auto& s : value) {
+         s = c.string_body();
+      }
+   }
+
+   template <has_fields T>
+   void read_view(cursor& c, T& value)
+   {
+      const auto n = c.object();
+      for (size_t i = 0; i < n && c.ok; ++i) {
+         const auto key = c.key();
+         if (!visit_field(value, key, [&](auto& member) { read_view(c, member); })) {
+            c.skip();
+         }
+      }
+   }
+}
+
+// MessagePack: arrays stay as the msgpack-c object array, strings reference the input buffer
+namespace msgpack_view
+{
+   // unpack_reference_func that makes msgpack-c point STR/BIN objects into the buffer instead of copying them
+   inline bool reference_all(msgpack::type::object_type, std::size_t, void*) { return true; }
+
+   using array = std::span<const msgpack::object>;
+
+   inline bool read_view(const msgpack::object& o, std::string_view& value)
+   {
+      if (o.type != msgpack::type::STR) {
+         return false;
+      }
+      value = {o.via.str.ptr, o.via.str.size};
+      return true;
+   }
+
+   inline bool read_view(const msgpack::object& o, bool& value)
+   {
+      if (o.type != msgpack::type::BOOLEAN) {
+         return false;
+      }
+      value = o.via.boolean;
+      return true;
+   }
+
+   inline bool read_view(const msgpack::object& o, double& value)
+   {
+      switch (o.type) {
+      case msgpack::type::FLOAT32:
+      case msgpack::type::FLOAT64:
+         value = o.via.f64;
+         return true;
+      case msgpack::type::POSITIVE_INTEGER:
+         value = double(o.via.u64);
+         return true;
+      case msgpack::type::NEGATIVE_INTEGER:
+         value = double(o.via.i64);
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   inline bool read_view(const msgpack::object& o, array& value)
+   {
+      if (o.type != msgpack::type::ARRAY) {
+         return false;
+      }
+      value = {o.via.array.ptr, o.via.array.size};
+      return true;
+   }
+
+   inline bool read_view(const msgpack::object& o, std::vector<std::string_view>& value)
+   {
+      if (o.type != msgpack::type::ARRAY) {
+         return false;
+      }
+      value.resize(o.via.array.size);
+      for (size_t i = 0; i < value.size(); ++i) {
+         if (!read_view(o.via.array.ptr[i], value[i])) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   template <has_fields T>
+   bool read_view(const msgpack::object& o, T& value)
+   {
+      if (o.type != msgpack::type::MAP) {
+         return false;
+      }
+      bool ok = true;
+      for (uint32_t i = 0; i < o.via.map.size && ok; ++i) {
+         const auto& kv = o.via.map.ptr[i];
+         if (kv.key.type != msgpack::type::STR) {
+            return false;
+         }
+         visit_field(value, std::string_view{kv.key.via.str.ptr, kv.key.via.str.size},
+                     [&](auto& member) { ok = read_view(kv.val, member); });
+      }
+      return ok;
+   }
+
+   // Follows map keys through the object tree. Returns nullptr when a key is missing or a value is not a map.
+   inline const msgpack::object* find(const msgpack::object& o, std::initializer_list<std::string_view> path)
+   {
+      const auto* node = &o;
+      for (const auto key : path) {
+         if (node->type != msgpack::type::MAP) {
+            return nullptr;
+         }
+         const msgpack::object* next = nullptr;
+         for (uint32_t i = 0; i < node->via.map.size && !next; ++i) {
+            const auto& kv = node->via.map.ptr[i];
+            if (kv.key.type == msgpack::type::STR && std::string_view{kv.key.via.str.ptr, kv.key.via.str.size} == key) {
+               next = &kv.val;
+            }
+         }
+         if (!next) {
+            return nullptr;
+         }
+         node = next;
+      }
+      return node;
+   }
+}
+
+// Protocol Buffers: arrays stay as the payload bytes of their (possibly repeated) field
+namespace pb_wire
+{
+   struct raw_field
+   {
+      std::string_view bytes{}; // from the first occurrence's payload to the end of the last occurrence
+      size_t count{}; // occurrences of the field
+   };
+
+   inline void read_view(cursor& c, wire_type type, std::string_view& value)
+   {
+      if (type != wire_type::len) {
+         c.fail();
+         return;
+      }
+      value = c.len();
+   }
+
+   inline void read_view(cursor& c, wire_type type, bool& value)
+   {
+      if (type != wire_type::varint) {
+         c.fail();
+         return;
+      }
+      value = c.varint() != 0;
+   }
+
+   inline void read_view(cursor& c, wire_type type, double& value)
+   {
+      if (type != wire_type::fixed64) {
+         c.fail();
+         return;
+      }
+      value = c.fixed<double>();
+   }
+
+   inline void read_view(cursor& c, wire_type type, raw_field& value)
+   {
+      if (type != wire_type::len) {
+         c.fail();
+         return;
+      }
+      const auto payload = c.len();
+      const auto* begin = value.count ? value.bytes.data() : payload.data();
+      value.bytes = {begin, size_t(payload.data() + payload.size() - begin)};
+      ++value.count;
+   }
+
+   inline void read_view(cursor& c, wire_type type, std::vector<std::string_view>& value)
+   {
+      if (type != wire_type::len) {
+         c.fail();
+         return;
+      }
+      value.push_back(c.len());
+   }
+
+   // Reads one message body; fields absent from the wire keep their default value
+   template <has_fields T>
+   void read_message(cursor& c, T& value)
+   {
+      for_each_field(value, [](auto& member, std::string_view, uint32_t) {
+         if constexpr (requires { member.clear(); }) {
+            member.clear(); // keeps capacity
+         }
+         else {
+            member = {};
+         }
+      });
+      uint32_t number{};
+      wire_type type{};
+      while (c.tag(number, type)) {
+         if (!visit_field(value, number, [&](auto& member) { read_view(c, type, member); })) {
+            c.skip(type);
+         }
+      }
+   }
+
+   template <has_fields T>
+   void read_view(cursor& c, wire_type type, T& value)
+   {
+      if (type != wire_type::len) {
+         c.fail();
+         return;
+      }
+      cursor sub{c.len()};
+      read_message(sub, value);
+      if (!sub.ok) {
+         c.fail();
+      }
+   }
+}
@@ -0,0 +1,90 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_counter.hpp"
+
+namespace
+{
+   void* allocate(std::size_t size, std::size_t alignment) noexcept
+   {
+      if (alignment <= alignof(std::max_align_t)) {
+         return std::malloc(size ? size : 1);
+      }
+      const auto rounded = (size + alignment - 1) / alignment * alignment;
+      return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+   }
+
+   void* counted_allocate(std::size_t size, std::size_t alignment) noexcept
+   {
+      auto* ptr = allocate(size, alignment);
+      if (ptr) {
+         auto& counts = thread_alloc_counts;
+         ++counts.allocations;
+         counts.bytes += size;
+      }
+      return ptr;
+   }
+
+   // As the replaceable operator new: on failure call the new handler and retry, throw once there is none
+   void* counted_allocate_or_throw(std::size_t size, std::size_t alignment)
+   {
+      while (true) {
+         if (auto* ptr = counted_allocate(size, alignment)) {
+            return ptr;
+         }
+         const auto handler = std::get_new_handler();
+         if (!handler) {
+            throw std::bad_alloc{};
+         }
+         handler();
+      }
+   }
+
+   void counted_deallocate(void* ptr) noexcept
+   {
+      if (ptr) {
+         ++thread_alloc_counts.deallocations;
+         std::free(ptr);
+      }
+   }
+
+   constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+void* operator new(std::size_t size) { return counted_allocate_or_throw(size, default_alignment); }
+void* operator new[](std::size_t size) { return counted_allocate_or_throw(size, default_alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+   return counted_allocate(size, default_alignment);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+   return counted_allocate(size, default_alignment);
+}
+void* operator new(std::size_t size, std::align_val_t al) { return counted_allocate_or_throw(size, std::size_t(al)); }
+void* operator new[](std::size_t size, std::align_val_t al)
+{
+   return counted_allocate_or_throw(size, std::size_t(al));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+   return counted_allocate(size, std::size_t(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+   return counted_allocate(size, std::size_t(al));
+}
+
+void operator delete(void* ptr) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { counted_deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
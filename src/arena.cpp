@@ -0,0 +1,158 @@
+// Arena mode: the complex object decoded into a new heap-backed obj_t and into a new arena::obj_t on an arena that is
+// released before each message, and encoded into a new buffer, a reused buffer and a fixed-capacity buffer
+
+#include <iostream>
+#include <memory_resource>
+
+#include "roofline.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr size_t arena_bytes = 64 * 1024; // arena and fixed write buffer; past it the arena falls back to the heap
+
+// An empty arena::obj_t whose strings and vectors allocate from r
+arena::obj_t arena_obj(std::pmr::memory_resource* r)
+{
+   using string = std::pmr::string;
+   return {
+      .fixed_object = {std::pmr::vector<int>(r), std::pmr::vector<float>(r), std::pmr::vector<double>(r)},
+      .fixed_name_object = {string(r), string(r), string(r), string(r), string(r)},
+      .another_object = {string(r), string(r), false, {std::pmr::vector<std::array<double, 3>>(r), string(r)}},
+      .string_array = std::pmr::vector<string>(r),
+      .string = string(r),
+      .number = 0.0,
+      .boolean = false,
+      .another_bool = false,
+   };
+}
+
+template <class Codec>
+arena_result run_arena(const obj_t& obj)
+{
+   arena_result r{std::string(Codec::name)};
+   std::string buffer{};
+   Codec::encode(obj, buffer);
+   r.size = buffer.size();
+
+   r.new_write = measure_for([&] {
+      std::string out{};
+      Codec::encode(obj, out);
+      roofline::clobber(out.data());
+   });
+   r.reused_write = measure_for([&] { Codec::encode(obj, buffer); });
+   if constexpr (fixed_writer<Codec, obj_t>) {
+      std::vector<char> fixed(arena_bytes);
+      if (Codec::encode_to(obj, fixed) == buffer.size()) {
+         r.fixed_write = measure_for([&] { Codec::encode_to(obj, fixed); });
+      }
+      else {
+         std::cerr << Codec::name << " fixed buffer write error!\n";
+      }
+   }
+
+   obj_t check{};
+   if (!Codec::decode(buffer, check)) {
+      std::cerr << Codec::name << " error!\n";
+      return r;
+   }
+   r.heap_read = measure_for([&] {
+      obj_t dst{};
+      Codec::decode(buffer, dst);
+   });
+
+   if constexpr (codec<Codec, arena::obj_t>) {
+      std::vector<std::byte> storage(arena_bytes);
+      std::pmr::monotonic_buffer_resource pool{storage.data(), storage.size()};
+      bool ok = false;
+      {
+         // The pmr types must round-trip to the same message
+         auto dst = arena_obj(&pool);
+         std::string again{};
+         if (Codec::decode(buffer, dst)) {
+            Codec::encode(dst, again);
+            ok = again == buffer;
+         }
+      }
+      if (ok) {
+         r.arena_read = measure_for([&] {
+            pool.release();
+            auto dst = arena_obj(&pool);
+            Codec::decode(buffer, dst);
+         });
+      }
+      else {
+         std::cerr << Codec::name << " arena error!\n";
+      }
+   }
+   return r;
+}
+
+std::string format_optional_throughput(uint64_t size, const std::optional<measurement>& m)
+{
+   return m ? format_throughput(size, *m) : "n/a";
+}
+
+} // namespace
+
+// Every registered codec that handles obj_t
+std::vector<arena_result> arena_test()
+{
+   const auto obj = make_obj();
+   std::vector<arena_result> results;
+   const auto run = [&](auto c) {
+      using C = decltype(c);
+      if constexpr (codec<C, obj_t>) {
+         if (codec_enabled<C>()) {
+            std::cout << "  " << C::name << "\n";
+            results.push_back(run_arena<C>(obj));
+         }
+      }
+   };
+   std::apply([&](auto... c) { (run(c), ...); }, all_codecs{});
+   return results;
+}
+
+void write_arena_section(std::ostream& out, const report& rep)
+{
+   const auto& arena = rep.arena;
+   if (arena.empty()) {
+      return;
+   }
+
+   out << "\n## Arena Allocation\n\n";
+   out << "The Complex Nested Object decoded into a new heap-backed `obj_t` and into a new `arena::obj_t`, the same ";
+   out << "structs on `std::pmr` strings and vectors, allocated from a " << format_size(arena_bytes) << " ";
+   out << "`std::pmr::monotonic_buffer_resource` that is released before each message. Writes go to a new ";
+   out << "`std::string`, to a reused `std::string` and to a preallocated " << format_size(arena_bytes) << " buffer. ";
+   out << "Each phase is timed for " << measure_defaults.target_seconds << " s. ";
+   out << "Allocations are heap allocations / bytes per operation. n/a: Protobuf through zpp_bits converts to its own ";
+   out << "message structs, which are not on the arena, and the Glaze writers and zlib only write into resizable ";
+   out << "buffers.\n\n";
+
+   out << "| Codec | Message Size | Heap Read | Arena Read | Arena Speedup | Heap Read Allocations | "
+          "Arena Read Allocations |\n";
+   out << "|-------|--------------|-----------|------------|---------------|-----------------------|"
+          "------------------------|\n";
+   for (const auto& a : arena) {
+      out << "| " << a.codec << " | " << format_size(a.size) << " | " << format_throughput(a.size, a.heap_read)
+          << " | " << format_optional_throughput(a.size, a.arena_read) << " | "
+          << (a.arena_read ? format_speedup(a.heap_read, *a.arena_read) : "n/a") << " | "
+          << format_allocs(a.heap_read) << " | " << (a.arena_read ? format_allocs(*a.arena_read) : "n/a") << " |\n";
+   }
+
+   out << "\n| Codec | New Buffer Write | Reused Buffer Write | Fixed Buffer Write | New Buffer Allocations | "
+          "Fixed Buffer Allocations |\n";
+   out << "|-------|------------------|---------------------|--------------------|------------------------|"
+          "--------------------------|\n";
+   for (const auto& a : arena) {
+      out << "| " << a.codec << " | " << format_throughput(a.size, a.new_write) << " | "
+          << format_throughput(a.size, a.reused_write) << " | " << format_optional_throughput(a.size, a.fixed_write)
+          << " | " << format_allocs(a.new_write) << " | " << (a.fixed_write ? format_allocs(*a.fixed_write) : "n/a")
+          << " |\n";
+   }
+}
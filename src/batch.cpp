@@ -0,0 +1,89 @@
+// Batch mode: std::vector<obj_t> encoded either as one container per format or as concatenated frames
+// (framed_codec), each a record_log length prefix followed by one independently encoded object
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr std::array<size_t, 5> batch_sizes{1, 16, 256, 4096, 65536};
+
+template <class Codec>
+results run_batch(size_t count)
+{
+   codec_bench<Codec, std::vector<obj_t>> bench{std::vector<obj_t>(count, make_obj())};
+   if (!bench.read() || bench.dst.size() != count) {
+      std::cerr << Codec::name << " batch of " << count << " error!\n";
+      return {};
+   }
+   return run_bench(bench, Codec::name);
+}
+
+// Objects per second and bytes per second for one batch operation
+std::string format_batch_rate(size_t count, uint64_t size, const measurement& m)
+{
+   const auto seconds = m.median();
+   if (seconds <= 0) {
+      return "n/a";
+   }
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(2) << (double(count) / seconds / 1e6) << "M msg/s, ";
+   oss << std::setprecision(0) << (double(size) / seconds / 1e6) << " MB/s";
+   return oss.str();
+}
+
+} // namespace
+
+std::vector<batch_point> batch_test()
+{
+   std::vector<batch_point> points;
+   for (const bool framed : {false, true}) {
+      for (const auto count : batch_sizes) {
+         std::cout << "  " << count << (framed ? " frames" : " objects in one container") << "\n";
+         const auto run = [&](auto c) {
+            using C = decltype(c);
+            return framed ? run_batch<framed_codec<C>>(count) : run_batch<C>(count);
+         };
+         points.push_back({count, framed, map_formats(run)});
+      }
+   }
+   return points;
+}
+
+void write_batch_section(std::ostream& out, const report& rep)
+{
+   const auto& batches = rep.batches;
+   if (batches.empty()) {
+      return;
+   }
+
+   out << "\n## Batches of Complex Objects\n\n";
+   out << "`std::vector<obj_t>` with copies of the complex object, encoded either as one container per format (a ";
+   out << "JSON/BEVE/CBOR/MessagePack array, a Protobuf message with `repeated obj_t`) or as concatenated frames, each a ";
+   out << "4 byte length prefix followed by one independently encoded object. Rates are objects and bytes per second.\n";
+
+   for (const bool framed : {false, true}) {
+      out << "\n### " << (framed ? "Length-Delimited Frames" : "One Container") << "\n\n";
+      write_format_header(out, {"Objects", "Size (BEVE)", "Phase"});
+      for (const auto& p : batches) {
+         if (p.framed != framed) {
+            continue;
+         }
+         for (auto phase : {&results::write, &results::read}) {
+            const auto label = std::to_string(p.count) + " | " +
+                               format_size(p.formats[format_index<beve_codec>].size) + " | " +
+                               (phase == &results::write ? "Write" : "Read");
+            write_format_row(out, label, [&](size_t f) {
+               const auto& r = p.formats[f];
+               return format_batch_rate(p.count, r.size, r.*phase);
+            });
+         }
+      }
+   }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "measure.hpp"
+#include "roofline.hpp"
+
+#include "codecs.hpp"
+
+struct results
+{
+   measurement write{};
+   measurement read{};
+   measurement read_fresh{}; // decoding into a freshly constructed destination every iteration
+   uint64_t size{};
+};
+
+// One value through one codec. Each bench owns its source value, destination and buffer, so that independent
+// instances can run on separate threads. write() encodes value, read() decodes into dst and returns false on a decode
+// error, reset() replaces dst with a default constructed value so the next read() cannot reuse its allocations.
+// bytes() is the encoded message and read(bytes) decodes a message held elsewhere, such as a record in a file.
+template <class Codec, class T>
+struct codec_bench
+{
+   using codec = Codec;
+
+   T value{};
+   T dst{};
+   std::string buffer{};
+
+   explicit codec_bench(T src) : value(std::move(src)) { write(); }
+
+   void write() { Codec::encode(value, buffer); }
+   bool read() { return Codec::decode(buffer, dst); }
+   bool read(std::string_view in) { return Codec::decode(in, dst); }
+   void reset() { dst = {}; }
+   std::string_view bytes() const { return buffer; }
+   uint64_t size() const { return buffer.size(); }
+};
+
+// The timed runner of every mode: each phase is timed for measure_defaults.target_seconds, so that one call covers
+// values of any size. Fresh-destination reads are only timed for benches that can reset their destination.
+template <class Bench>
+results run_bench(Bench& bench, std::string_view name)
+{
+   results r{};
+   r.write = measure_for([&] { bench.write(); });
+   r.size = bench.size();
+   if (!bench.read()) {
+      std::cerr << name << " error!\n";
+      return r;
+   }
+   r.read = measure_for([&] { bench.read(); });
+   if constexpr (requires { bench.reset(); }) {
+      r.read_fresh = measure_for([&] {
+         bench.reset();
+         bench.read();
+      });
+   }
+   return r;
+}
+
+template <class Codec, class T>
+results run_codec(T value)
+{
+   codec_bench<Codec, T> bench{std::move(value)};
+   return run_bench(bench, Codec::name);
+}
+
+// The same value through every format, in column order
+template <class T>
+std::array<results, format_count> run_formats(const T& value)
+{
+   return map_formats([&](auto c) { return run_codec<decltype(c)>(value); });
+}
+
+// Benches used in turn, so that consecutive operations touch different messages. The order is optionally shuffled so
+// that prefetchers cannot follow it. size() is the mean message size.
+template <class Bench>
+struct bench_pool
+{
+   std::vector<Bench> benches{};
+   std::vector<size_t> order{};
+   size_t i{};
+
+   bench_pool(std::vector<Bench> pool, bool shuffle) : benches(std::move(pool)), order(benches.size())
+   {
+      std::iota(order.begin(), order.end(), size_t(0));
+      if (shuffle) {
+         std::shuffle(order.begin(), order.end(), std::mt19937_64{});
+      }
+      for (auto& bench : benches) {
+         bench.read(); // size the destination so steady-state reads do not allocate
+      }
+   }
+
+   Bench& next()
+   {
+      auto& bench = benches[order[i]];
+      i = (i + 1 == order.size()) ? 0 : i + 1;
+      return bench;
+   }
+
+   void write() { next().write(); }
+   bool read() { return next().read(); }
+
+   uint64_t size() const
+   {
+      uint64_t bytes{};
+      for (const auto& bench : benches) {
+         bytes += bench.size();
+      }
+      return bytes / benches.size();
+   }
+};
+
+// Memory bandwidth roofline (roofline.hpp): memcpy and a non-temporal copy of a given size, so a format's throughput
+// can be read as a fraction of what a plain copy of its bytes achieves on this machine
+struct roofline_point
+{
+   measurement copy;
+   measurement stream;
+
+   // Median time of the faster copy kernel
+   double best() const { return (std::min)(copy.median(), stream.median()); }
+};
+
+inline roofline_point run_roofline(uint64_t bytes)
+{
+   std::vector<char> src(bytes, 'x');
+   std::vector<char> dst(bytes);
+   roofline_point p{};
+   p.copy = measure_for([&] { roofline::copy(dst.data(), src.data(), src.size()); });
+   p.stream = measure_for([&] { roofline::stream_copy(dst.data(), src.data(), src.size()); });
+   return p;
+}
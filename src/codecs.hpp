@@ -0,0 +1,512 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "glaze/glaze.hpp"
+#include "glaze/beve.hpp"
+#include "glaze/cbor.hpp"
+#include "glaze/msgpack.hpp"
+
+#include "entropy.hpp"
+#include "msgpack_direct.hpp"
+#include "pb_direct.hpp"
+#include "raw_codec.hpp"
+#include "record_log.hpp"
+#include "views.hpp"
+
+#include "types.hpp"
+
+// Codecs: stateless encode/decode pairs, the only place a format is spelled out. Every mode runs them through
+// codec_bench (bench.hpp). encode() replaces the contents of a reusable buffer, whose size is the message size, and
+// decode() reads into a target whose capacity it may reuse, returning false on a decode error. The protobuf
+// conversion is kept inside the timed call. name is shown in reports, id selects the codec on the command line.
+template <class C, class T>
+concept codec = requires(const T& value, T& target, std::string& buffer, std::string_view in) {
+   { C::name } -> std::convertible_to<std::string_view>;
+   { C::id } -> std::convertible_to<std::string_view>;
+   C::encode(value, buffer);
+   { C::decode(in, target) } -> std::same_as<bool>;
+};
+
+// Codecs that can also write into a preallocated buffer of fixed capacity. encode_to() returns the message size, or
+// 0 when the message does not fit.
+template <class C, class T>
+concept fixed_writer = codec<C, T> && requires(const T& value, std::span<char> out) {
+   { C::encode_to(value, out) } -> std::same_as<size_t>;
+};
+
+// Codecs that depend on an optional library set enabled to false when it is missing
+template <class C>
+constexpr bool codec_enabled()
+{
+   if constexpr (requires { C::enabled; }) {
+      return C::enabled;
+   }
+   else {
+      return true;
+   }
+}
+
+// Signed integers are encoded as zig-zag varints (sint32/sint64), as the complex object's int_array is
+template <class T>
+using pb_element_t = std::conditional_t<std::same_as<T, int32_t>, zpp::bits::vsint32_t,
+                                        std::conditional_t<std::same_as<T, int64_t>, zpp::bits::vsint64_t, T>>;
+
+// Protobuf vector wrapper for proper encoding
+template <typename T>
+struct pb_vector_wrapper {
+   std::vector<pb_element_t<T>> data;
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct json_codec
+{
+   static constexpr std::string_view name = "JSON";
+   static constexpr std::string_view id = "json";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      [[maybe_unused]] auto ec = glz::write_json(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return !glz::read<glz::opts{.null_terminated = false}>(value, in);
+   }
+
+   // A std::string is null terminated, which spares Glaze its end-of-buffer checks
+   template <class T>
+   static bool decode(const std::string& in, T& value)
+   {
+      return !glz::read_json(value, in);
+   }
+};
+
+struct beve_codec
+{
+   static constexpr std::string_view name = "BEVE";
+   static constexpr std::string_view id = "beve";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      [[maybe_unused]] auto ec = glz::write_beve(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return !glz::read_beve(value, in);
+   }
+};
+
+struct msgpack_codec
+{
+   static constexpr std::string_view name = "MessagePack";
+   static constexpr std::string_view id = "msgpack";
+
+   // msgpack::pack writes to any stream with write(const char*, size_t)
+   struct string_stream
+   {
+      std::string& out;
+      void write(const char* data, size_t size) { out.append(data, size); }
+   };
+
+   // Drops everything after the first write that does not fit
+   struct span_stream
+   {
+      std::span<char> out;
+      size_t size = 0;
+      bool overflow = false;
+
+      void write(const char* data, size_t n)
+      {
+         if (overflow || n > out.size() - size) {
+            overflow = true;
+            return;
+         }
+         std::memcpy(out.data() + size, data, n);
+         size += n;
+      }
+   };
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      out.clear();
+      string_stream stream{out};
+      msgpack::pack(stream, value);
+   }
+
+   template <class T>
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      span_stream stream{out};
+      msgpack::pack(stream, value);
+      return stream.overflow ? 0 : stream.size;
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      msgpack::object_handle oh = msgpack::unpack(in.data(), in.size());
+      oh.get().convert(value);
+      return true;
+   }
+};
+
+struct cbor_codec
+{
+   static constexpr std::string_view name = "CBOR";
+   static constexpr std::string_view id = "cbor";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      [[maybe_unused]] auto ec = glz::write_cbor(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return !glz::read_cbor(value, in);
+   }
+};
+
+template <class T>
+concept numeric_vector = raw_codec::is_vector<T>::value && std::is_arithmetic_v<typename T::value_type>;
+
+template <class T>
+concept pb_convertible = requires(const T& value) { pb::from_pb(pb::to_pb(value)); };
+
+// Numeric vectors go through pb_vector_wrapper, everything else through the pb:: structs
+struct protobuf_codec
+{
+   static constexpr std::string_view name = "Protobuf";
+   static constexpr std::string_view id = "protobuf";
+
+   // The wrapper is reused per thread, so copying a vector into it does not allocate once it has grown
+   template <class T>
+   static decltype(auto) to_message(const T& value)
+   {
+      if constexpr (numeric_vector<T>) {
+         thread_local pb_vector_wrapper<typename T::value_type> message{};
+         message.data.assign(value.begin(), value.end());
+         return static_cast<const pb_vector_wrapper<typename T::value_type>&>(message);
+      }
+      else {
+         return pb::to_pb(value);
+      }
+   }
+
+   template <class T>
+      requires(numeric_vector<T> || pb_convertible<T>)
+   static void encode(const T& value, std::string& out)
+   {
+      out.clear();
+      auto stream = zpp::bits::out(out, zpp::bits::no_size{});
+      [[maybe_unused]] auto result = stream(to_message(value));
+   }
+
+   template <class T>
+      requires(numeric_vector<T> || pb_convertible<T>)
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      std::span<std::byte> view{reinterpret_cast<std::byte*>(out.data()), out.size()};
+      auto stream = zpp::bits::out(view, zpp::bits::no_size{});
+      return stream(to_message(value)).failure() ? 0 : stream.position();
+   }
+
+   template <class T>
+      requires(numeric_vector<T> || pb_convertible<T>)
+   static bool decode(std::string_view in, T& value)
+   {
+      std::span<const std::byte> view{reinterpret_cast<const std::byte*>(in.data()), in.size()};
+      auto stream = zpp::bits::in(view, zpp::bits::no_size{});
+      if constexpr (numeric_vector<T>) {
+         using element = typename T::value_type;
+         if constexpr (std::same_as<pb_element_t<element>, element>) {
+            // Decoded in place, so a reused destination keeps its capacity
+            pb_vector_wrapper<element> message{std::move(value)};
+            message.data.clear();
+            const auto result = stream(message);
+            value = std::move(message.data);
+            return !result.failure();
+         }
+         else {
+            pb_vector_wrapper<element> message{};
+            const auto result = stream(message);
+            value.assign(message.data.begin(), message.data.end());
+            return !result.failure();
+         }
+      }
+      else {
+         decltype(pb::to_pb(value)) message{};
+         const auto result = stream(message);
+         value = pb::from_pb(message);
+         return !result.failure();
+      }
+   }
+};
+
+// MessagePack written by msgpack-c and read through msgpack_direct.hpp: parse() events routed straight into the
+// value through its field table, with no object tree
+struct msgpack_visitor_codec
+{
+   static constexpr std::string_view name = "msgpack-c Visitor";
+   static constexpr std::string_view id = "msgpack-visitor";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      msgpack_codec::encode(value, out);
+   }
+
+   template <class T>
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      return msgpack_codec::encode_to(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      thread_local msgpack_direct::reader reader{};
+      return reader.read(in, value);
+   }
+};
+
+// msgpack-c unpack + convert into one long-lived zone: clear() keeps the first chunk, so once it holds the whole
+// object tree no read allocates for the tree, and strings are referenced from the buffer instead of copied into it
+constexpr size_t msgpack_zone_chunk = 64 * 1024;
+
+struct msgpack_zone_codec
+{
+   static constexpr std::string_view name = "msgpack-c Zone Reuse";
+   static constexpr std::string_view id = "msgpack-zone";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      msgpack_codec::encode(value, out);
+   }
+
+   template <class T>
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      return msgpack_codec::encode_to(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      thread_local msgpack::zone zone{msgpack_zone_chunk};
+      zone.clear();
+      msgpack::unpack(zone, in.data(), in.size(), msgpack_view::reference_all).convert(value);
+      return true;
+   }
+};
+
+// MessagePack (Glaze), same format as msgpack-c but with Glaze's compile-time reflected reader and writer
+struct glaze_msgpack_codec
+{
+   static constexpr std::string_view name = "Glaze MessagePack";
+   static constexpr std::string_view id = "glaze-msgpack";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      [[maybe_unused]] auto ec = glz::write_msgpack(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return !glz::read_msgpack(value, in);
+   }
+};
+
+// Protobuf straight from types with a field table (pb_direct.hpp), without the pb:: structs and conversion
+struct protobuf_direct_codec
+{
+   static constexpr std::string_view name = "Protobuf Direct";
+   static constexpr std::string_view id = "protobuf-direct";
+
+   template <has_fields T>
+   static void encode(const T& value, std::string& out)
+   {
+      pb_direct::encode(value, out);
+   }
+
+   template <has_fields T>
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      const auto size = pb_direct::message_size(value);
+      if (size > out.size()) {
+         return 0;
+      }
+      pb_direct::write_message(out.data(), value);
+      return size;
+   }
+
+   template <has_fields T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return pb_direct::decode(in, value);
+   }
+};
+
+// Hand-written raw struct codec (raw_codec.hpp): no keys, tags or type information, the floor for a structured format
+struct raw_struct_codec
+{
+   static constexpr std::string_view name = "Raw Struct";
+   static constexpr std::string_view id = "raw";
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      raw_codec::encode(value, out);
+   }
+
+   template <class T>
+   static size_t encode_to(const T& value, std::span<char> out)
+   {
+      const auto size = raw_codec::encoded_size(value);
+      if (size > out.size()) {
+         return 0;
+      }
+      raw_codec::write(out.data(), value);
+      return size;
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return raw_codec::decode(in, value);
+   }
+};
+
+// Any codec followed by the zlib entropy stage (entropy.hpp), one compressed block per message
+template <class Inner>
+struct deflate_codec
+{
+   static inline const std::string name = std::string(Inner::name) + " + zlib";
+   static inline const std::string id = std::string(Inner::id) + "+zlib";
+   static constexpr bool enabled = entropy::available;
+
+   template <class T>
+      requires codec<Inner, T>
+   static void encode(const T& value, std::string& out)
+   {
+      thread_local std::string plain{};
+      thread_local entropy::compressor compressor{};
+      Inner::encode(value, plain);
+      if (!compressor.compress(plain, out)) {
+         out.clear();
+      }
+   }
+
+   template <class T>
+      requires codec<Inner, T>
+   static bool decode(std::string_view in, T& value)
+   {
+      thread_local std::string plain{};
+      thread_local entropy::decompressor decompressor{};
+      return decompressor.decompress(in, plain) && Inner::decode(plain, value);
+   }
+};
+
+// A vector of values as concatenated frames, each a record_log length prefix followed by one value encoded on its
+// own by any codec, instead of one container
+template <class Inner>
+struct framed_codec
+{
+   static inline const std::string name = std::string(Inner::name) + " frames";
+   static inline const std::string id = std::string(Inner::id) + "-frames";
+
+   template <class T>
+      requires codec<Inner, T>
+   static void encode(const std::vector<T>& values, std::string& out)
+   {
+      thread_local std::string frame{};
+      out.clear();
+      for (const auto& value : values) {
+         Inner::encode(value, frame);
+         char prefix[record_log::prefix_size];
+         record_log::put_prefix(prefix, uint32_t(frame.size()));
+         out.append(prefix, record_log::prefix_size);
+         out.append(frame);
+      }
+   }
+
+   template <class T>
+      requires codec<Inner, T>
+   static bool decode(std::string_view in, std::vector<T>& values)
+   {
+      size_t count = 0;
+      while (!in.empty()) {
+         if (in.size() < record_log::prefix_size) {
+            return false;
+         }
+         const auto size = record_log::get_prefix(in.data());
+         in.remove_prefix(record_log::prefix_size);
+         if (in.size() < size) {
+            return false;
+         }
+         if (count == values.size()) {
+            values.emplace_back();
+         }
+         if (!Inner::decode(in.substr(0, size), values[count++])) {
+            return false;
+         }
+         in.remove_prefix(size);
+      }
+      values.resize(count);
+      return true;
+   }
+};
+
+// The formats compared throughout the report, in column order. Every mode runs each of them through the same
+// codec_bench and every table has a column per entry, so a format added here shows up everywhere.
+using formats = std::tuple<json_codec, beve_codec, msgpack_codec, cbor_codec, protobuf_codec>;
+
+constexpr size_t format_count = std::tuple_size_v<formats>;
+
+constexpr auto format_names = std::apply(
+   [](auto... c) { return std::array<std::string_view, format_count>{decltype(c)::name...}; }, formats{});
+
+constexpr auto format_ids = std::apply(
+   [](auto... c) { return std::array<std::string_view, format_count>{decltype(c)::id...}; }, formats{});
+
+// Column of a format in formats
+template <class Codec>
+constexpr size_t format_index = []<class... Cs>(std::tuple<Cs...>) {
+   constexpr std::array matches{std::same_as<Codec, Cs>...};
+   return size_t(std::ranges::find(matches, true) - matches.begin());
+}(formats{});
+
+// f(codec) for every format, collected in column order
+template <class F>
+auto map_formats(F&& f)
+{
+   return std::apply([&](auto... c) { return std::array{f(c)...}; }, formats{});
+}
+
+// Every codec: the formats and the alternative readers, writers and stages measured by the matrix, RPC and arena
+// modes. A mode runs each codec on the payloads it supports.
+using all_codecs = std::tuple<json_codec, beve_codec, msgpack_codec, msgpack_visitor_codec, msgpack_zone_codec,
+                              glaze_msgpack_codec, cbor_codec, protobuf_codec, protobuf_direct_codec, raw_struct_codec,
+                              deflate_codec<beve_codec>, deflate_codec<msgpack_codec>, deflate_codec<protobuf_codec>>;
@@ -0,0 +1,130 @@
+// Cache-cold mode: every iteration uses the next bench from a pool whose total footprint (source value, destination
+// value and serialized buffer) is larger than the last-level cache, so neither the input bytes nor the destination
+// are cache resident and each decode starts from a cold message.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+
+#include "cache_info.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+// Heap bytes held by a value: the capacity of its strings and vectors, and of everything they hold in turn. Strings
+// short enough for the small string buffer hold none.
+template <class T>
+uint64_t heap_bytes(const T& value)
+{
+   if constexpr (char_string<T>) {
+      return value.capacity() > T{}.capacity() ? value.capacity() + 1 : 0;
+   }
+   else if constexpr (requires { value.capacity(); }) {
+      uint64_t bytes = value.capacity() * sizeof(typename T::value_type);
+      if constexpr (!std::is_trivially_copyable_v<typename T::value_type>) {
+         for (const auto& element : value) {
+            bytes += heap_bytes(element);
+         }
+      }
+      return bytes;
+   }
+   else if constexpr (has_fields<T>) {
+      uint64_t bytes{};
+      for_each_field(value, [&](const auto& member, std::string_view, uint32_t) { bytes += heap_bytes(member); });
+      return bytes;
+   }
+   else {
+      return 0;
+   }
+}
+
+// The pool is sized on the bytes a bench keeps live once its destination has been read into, which is what the
+// timed loop cycles through, rather than on what constructing it allocated along the way
+template <class Codec, class T>
+void run_cold(cold_result& r, const T& value, uint64_t pool_bytes, bool shuffle)
+{
+   using bench = codec_bench<Codec, T>;
+   auto& p = r.pools[format_index<Codec>];
+   {
+      bench probe{value};
+      probe.read();
+      p.footprint = sizeof(bench) + probe.buffer.capacity() + 1 + heap_bytes(probe.value) + heap_bytes(probe.dst);
+   }
+   p.count = (std::max)(size_t(1024), size_t(pool_bytes / p.footprint));
+
+   std::vector<bench> benches;
+   benches.reserve(p.count);
+   for (size_t i = 0; i < p.count; ++i) {
+      benches.emplace_back(value);
+   }
+   bench_pool<bench> pool{std::move(benches), shuffle};
+   r.formats[format_index<Codec>] = run_bench(pool, Codec::name);
+}
+
+template <class T>
+cold_result cold_payload(std::string name, const T& value, uint64_t pool_bytes, bool shuffle)
+{
+   std::cout << "  " << name << "\n";
+   cold_result r{std::move(name), {}};
+   std::apply([&](auto... c) { (run_cold<decltype(c)>(r, value, pool_bytes, shuffle), ...); }, formats{});
+   return r;
+}
+
+} // namespace
+
+std::vector<cold_result> cold_test(uint64_t pool_bytes, bool shuffle)
+{
+   std::vector<cold_result> results;
+   results.push_back(cold_payload("Complex Nested Object", make_obj(), pool_bytes, shuffle));
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      results.push_back(
+         cold_payload("std::vector<" + std::string(type) + "> (10K)", random_vector<T>(), pool_bytes, shuffle));
+   });
+   return results;
+}
+
+void write_cold_section(std::ostream& out, const report& rep)
+{
+   if (rep.cold.empty()) {
+      return;
+   }
+
+   out << "\n## Cache-Cold vs Hot\n\n";
+   out << "Hot runs encode and decode the same buffer and object every iteration. ";
+   out << "Cold runs cycle through a pool of at least 1024 independent copies of the payload, each with its own ";
+   out << "source object, destination object and serialized buffer, with a combined footprint of at least "
+       << format_size(rep.cold_pool_bytes) << " per format (LLC: " << format_size(detect_caches().llc) << "), visited in "
+       << (rep.cold_shuffled ? "shuffled" : "sequential") << " order. ";
+   out << "Pool Footprint counts the bytes each copy holds after a read: the bench itself, the capacity of its ";
+   out << "buffer and of every string and vector in both objects.\n";
+
+   for (const auto& c : rep.cold) {
+      const auto hot = std::find_if(rep.results.begin(), rep.results.end(),
+                                    [&](const benchmark_result& r) { return r.name == c.name; });
+      if (hot == rep.results.end()) {
+         continue;
+      }
+      out << "\n### " << c.name << "\n\n";
+      write_format_header(out, {"Metric"});
+      write_format_row(out, "Pool Size", [&](size_t f) { return std::to_string(c.pools[f].count); });
+      write_format_row(out, "Pool Footprint",
+                       [&](size_t f) { return format_size(c.pools[f].count * c.pools[f].footprint); });
+      for (auto phase : {&results::write, &results::read}) {
+         const std::string label = phase == &results::write ? "Write" : "Read";
+         const auto throughput = [&](const results& r) { return format_throughput(r.size, (r.*phase).median()); };
+         write_format_row(out, "Hot " + label, [&](size_t f) { return throughput(hot->formats[f]); });
+         write_format_row(out, "Cold " + label, [&](size_t f) { return throughput(c.formats[f]); });
+         write_format_row(out, "Cold / Hot " + label, [&](size_t f) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(0)
+                << (100.0 * (hot->formats[f].*phase).median() / (c.formats[f].*phase).median()) << "%";
+            return oss.str();
+         });
+      }
+   }
+}
@@ -0,0 +1,215 @@
+// Machine-readable results and the compare mode, which gates a library upgrade on two of them
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "format.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+// Machine-readable results for the compare mode: the per-trial seconds per operation of every timed phase, keyed by
+// "<test>/<format>" (missing phases are empty)
+struct sample_record
+{
+   std::string name;
+   uint64_t size{};
+   std::vector<double> write;
+   std::vector<double> read;
+   std::vector<double> read_fresh;
+};
+
+struct run_record
+{
+   std::string date;
+   std::string glaze;
+   std::string msgpack;
+   std::vector<sample_record> benchmarks;
+};
+
+run_record make_run_record(const report& rep)
+{
+   run_record record{};
+   const auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+   std::tm tm = *std::localtime(&time);
+   std::ostringstream date;
+   date << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
+   record.date = date.str();
+   record.glaze = std::to_string(int(glz::version.major)) + "." + std::to_string(int(glz::version.minor)) + "." +
+                  std::to_string(int(glz::version.patch));
+   record.msgpack = "7.0.0";
+
+   const auto add = [&](std::string name, const results& r) {
+      record.benchmarks.push_back({std::move(name), r.size, r.write.trials, r.read.trials, r.read_fresh.trials});
+   };
+   const auto add_formats = [&](const std::string& prefix, const format_results& formats) {
+      for (size_t f = 0; f < format_count; ++f) {
+         add(prefix + std::string(format_names[f]), formats[f]);
+      }
+   };
+   for (size_t i = 0; i < rep.results.size(); ++i) {
+      const auto& r = rep.results[i];
+      add_formats(r.name + "/", r.formats);
+      if (i < rep.roofline.size()) {
+         add(r.name + "/Raw Struct", rep.roofline[i].raw);
+      }
+   }
+   if (rep.protobuf_direct) {
+      add("Complex Nested Object/" + std::string(protobuf_direct_codec::name), *rep.protobuf_direct);
+   }
+   if (rep.msgpack_strategies) {
+      std::apply(
+         [&](auto... c) {
+            size_t i = 0;
+            (add("Complex Nested Object/" + std::string(decltype(c)::name), (*rep.msgpack_strategies)[i++]), ...);
+         },
+         msgpack_strategies{});
+   }
+   for (const auto& d : rep.distributions) {
+      for (const auto& p : d.points) {
+         const auto prefix = d.name + " " + std::string(distribution_name(p.dist)) + "/";
+         add_formats(prefix, p.formats);
+      }
+   }
+   for (const auto& p : rep.batches) {
+      const auto prefix = "Batch of " + std::to_string(p.count) + (p.framed ? " frames/" : " objects/");
+      add_formats(prefix, p.formats);
+   }
+   for (const auto& p : rep.layouts) {
+      for (size_t f = 0; f < format_count; ++f) {
+         const auto prefix = std::to_string(p.points) + " points ";
+         add(prefix + "AoS/" + std::string(format_names[f]), p.formats[f].aos);
+         add(prefix + "SoA/" + std::string(format_names[f]), p.formats[f].soa);
+      }
+   }
+   for (const auto& c : rep.matrix) {
+      add("Matrix " + c.payload + " (" + std::to_string(c.size) + ")/" + c.codec, c.result);
+   }
+   // Heap: new-buffer write and fresh heap read; arena: fixed-buffer write and arena read, where the codec has them
+   for (const auto& a : rep.arena) {
+      const auto trials = [](const std::optional<measurement>& m) { return m ? m->trials : std::vector<double>{}; };
+      record.benchmarks.push_back(
+         {"Arena heap/" + a.codec, a.size, a.new_write.trials, a.heap_read.trials, a.heap_read.trials});
+      record.benchmarks.push_back(
+         {"Arena pmr/" + a.codec, a.size, trials(a.fixed_write), trials(a.arena_read), trials(a.arena_read)});
+   }
+   for (const auto& v : rep.validation) {
+      for (size_t i = 0; i < v.formats.size(); ++i) {
+         const auto& p = v.formats[i];
+         record.benchmarks.push_back(
+            {"Validate " + v.name + "/" + std::string(format_names[i]), p.size, {}, p.validate.trials, {}});
+      }
+   }
+   for (const auto& e : rep.evolution) {
+      for (const auto& p : e.points) {
+         const auto unknown = p.unknown ? " (" + std::to_string(p.unknown) + ")" : std::string{};
+         record.benchmarks.push_back({"Evolution " + std::string(p.variant) + unknown + "/" + e.codec, p.size,
+                                      {}, p.read.trials, {}});
+      }
+   }
+   return record;
+}
+
+} // namespace
+
+void write_results_json(const report& rep, const std::string& filename)
+{
+   std::string buffer;
+   if (const auto ec = glz::write_file_json(make_run_record(rep), filename, buffer)) {
+      std::cerr << "Cannot write " << filename << ": " << glz::format_error(ec, buffer) << "\n";
+      return;
+   }
+   std::cout << "Raw samples written to: " << filename << "\n";
+}
+
+// Compares two results.json files phase by phase. A change counts as a regression (or an improvement) when the mean
+// time per operation moved by more than threshold_percent and Welch's t test finds the difference of the means
+// significant at 95%. Returns the process exit code: 1 when anything regressed or a baseline benchmark is missing from
+// the candidate (the gate cannot vouch for what it did not measure), so the mode can gate a library upgrade.
+int compare_runs(const std::string& baseline_file, const std::string& candidate_file, double threshold_percent)
+{
+   run_record baseline{};
+   run_record candidate{};
+   std::string buffer;
+   for (auto [record, file] : {std::pair{&baseline, &baseline_file}, std::pair{&candidate, &candidate_file}}) {
+      if (const auto ec = glz::read_file_json(*record, *file, buffer)) {
+         std::cerr << "Cannot read " << *file << ": " << glz::format_error(ec, buffer) << "\n";
+         return 2;
+      }
+   }
+
+   std::cout << "# Comparison\n\n";
+   std::cout << "Baseline: " << baseline_file << " (" << baseline.date << ", Glaze " << baseline.glaze << ")\n";
+   std::cout << "Candidate: " << candidate_file << " (" << candidate.date << ", Glaze " << candidate.glaze << ")\n";
+   std::cout << "Threshold: " << threshold_percent
+             << "% change in mean time per operation, Welch's t test on the trial means at 95%\n\n";
+   std::cout << "Baseline and Candidate are the mean time per operation across trials.\n\n";
+   std::cout << "| Benchmark | Phase | Baseline | Candidate | Change | t | Verdict |\n";
+   std::cout << "|-----------|-------|----------|-----------|--------|---|---------|\n";
+
+   size_t regressions{};
+   size_t improvements{};
+   size_t added{};
+   std::vector<std::string_view> dropped{};
+   for (const auto& b : baseline.benchmarks) {
+      if (std::none_of(candidate.benchmarks.begin(), candidate.benchmarks.end(),
+                       [&](const sample_record& r) { return r.name == b.name; })) {
+         dropped.push_back(b.name);
+      }
+   }
+   for (const auto& c : candidate.benchmarks) {
+      const auto b = std::find_if(baseline.benchmarks.begin(), baseline.benchmarks.end(),
+                                  [&](const sample_record& r) { return r.name == c.name; });
+      if (b == baseline.benchmarks.end()) {
+         ++added;
+         continue;
+      }
+      for (auto phase : {&sample_record::write, &sample_record::read, &sample_record::read_fresh}) {
+         if (((*b).*phase).empty() || (c.*phase).empty()) {
+            continue;
+         }
+         measurement before{};
+         measurement after{};
+         before.trials = (*b).*phase;
+         after.trials = c.*phase;
+         const auto change = 100.0 * (after.mean() / before.mean() - 1.0);
+         const auto w = welch_test(before, after);
+         std::string_view verdict = "";
+         if (w.significant && change > threshold_percent) {
+            verdict = "**regression**";
+            ++regressions;
+         }
+         else if (w.significant && change < -threshold_percent) {
+            verdict = "improvement";
+            ++improvements;
+         }
+         const std::string_view label = phase == &sample_record::write  ? "Write"
+                                        : phase == &sample_record::read ? "Read"
+                                                                        : "Fresh Read";
+         std::cout << "| " << c.name << " | " << label << " | " << format_time(before.mean()) << " | "
+                   << format_time(after.mean()) << " | " << std::showpos << std::fixed << std::setprecision(1)
+                   << change << "%" << std::noshowpos << " | " << std::setprecision(2) << w.t << " | " << verdict
+                   << " |\n";
+      }
+   }
+
+   std::cout << "\n" << regressions << " regression(s), " << improvements << " improvement(s)";
+   if (added) {
+      std::cout << ", " << added << " benchmark(s) missing from the baseline";
+   }
+   if (!dropped.empty()) {
+      std::cout << ", " << dropped.size() << " baseline benchmark(s) missing from the candidate";
+   }
+   std::cout << "\n";
+   if (!dropped.empty()) {
+      std::cout << "\nMissing from the candidate (**failed**):\n\n";
+      for (const auto name : dropped) {
+         std::cout << "- " << name << "\n";
+      }
+   }
+   return regressions || !dropped.empty() ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// Value-distribution matrix: every format on vectors of one element type drawn from each distribution, each phase
+// timed for the configured duration because the slow combinations (JSON, full-range varints) would otherwise dominate
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+template <class T>
+std::vector<T> distributed_vector(distribution d, size_t n = vector_size)
+{
+   if (d == distribution::full_range) {
+      return random_vector<T>(n);
+   }
+
+   std::mt19937_64 gen{};
+   std::vector<T> x(n);
+   switch (d) {
+   case distribution::small: // integers in [0, 100), or [-100, 100) when signed; floating point in [0, 1)
+      for (auto& v : x) {
+         if constexpr (std::is_floating_point_v<T>) {
+            v = std::uniform_real_distribution<T>{0, 1}(gen);
+         }
+         else {
+            v = T(std::uniform_int_distribution<int>{std::is_signed_v<T> ? -100 : 0, 99}(gen));
+         }
+      }
+      break;
+   case distribution::zipf: { // ranks 1..K with P(k) proportional to 1 / k^1.1, by inverting the tabulated CDF
+      size_t ranks = 1'000'000;
+      if constexpr (std::is_integral_v<T>) {
+         ranks = size_t((std::min)(uint64_t(ranks), uint64_t((std::numeric_limits<T>::max)())));
+      }
+      std::vector<double> cdf(ranks);
+      double sum = 0.0;
+      for (size_t k = 0; k < ranks; ++k) {
+         sum += 1.0 / std::pow(double(k + 1), 1.1);
+         cdf[k] = sum;
+      }
+      std::uniform_real_distribution<double> u{0.0, sum};
+      for (auto& v : x) {
+         v = T(std::lower_bound(cdf.begin(), cdf.end(), u(gen)) - cdf.begin() + 1);
+      }
+      break;
+   }
+   case distribution::monotonic: { // sorted timestamps: milliseconds since the epoch for 64-bit types
+      if constexpr (std::is_floating_point_v<T>) {
+         T t = sizeof(T) == 8 ? T(1'700'000'000.0) : T(0);
+         for (auto& v : x) {
+            t += std::uniform_real_distribution<T>{0, 1}(gen);
+            v = t;
+         }
+      }
+      else {
+         T t = sizeof(T) == 8 ? T(1'700'000'000'000) : T(0);
+         const auto headroom = uint64_t((std::numeric_limits<T>::max)()) / (std::max)(n, size_t(1));
+         std::uniform_int_distribution<uint64_t> step{1, std::clamp(headroom, uint64_t(1), uint64_t(1000))};
+         for (auto& v : x) {
+            t = T(t + T(step(gen)));
+            v = t;
+         }
+      }
+      break;
+   }
+   case distribution::sparse_zero: { // 90% zeros, the rest full range
+      const auto values = random_vector<T>(n, std::mt19937_64::default_seed + 1); // independent of the zero mask
+      std::bernoulli_distribution nonzero{0.1};
+      for (size_t i = 0; i < n; ++i) {
+         x[i] = nonzero(gen) ? values[i] : T(0);
+      }
+      break;
+   }
+   case distribution::full_range:
+      break;
+   }
+   return x;
+}
+
+template <class T>
+distribution_result distribution_payload(std::string name)
+{
+   distribution_result r{std::move(name), {}};
+   for (const auto d : all_distributions) {
+      std::cout << "  " << r.name << ": " << distribution_name(d) << "\n";
+      r.points.push_back({d, run_formats(distributed_vector<T>(d))});
+   }
+   return r;
+}
+
+} // namespace
+
+std::vector<distribution_result> distribution_test()
+{
+   return {distribution_payload<uint64_t>("std::vector<uint64_t> (10K)"),
+           distribution_payload<uint32_t>("std::vector<uint32_t> (10K)"),
+           distribution_payload<int64_t>("std::vector<int64_t> (10K)"),
+           distribution_payload<int32_t>("std::vector<int32_t> (10K)"),
+           distribution_payload<double>("std::vector<double> (10K)"),
+           distribution_payload<float>("std::vector<float> (10K)")};
+}
+
+void write_distribution_section(std::ostream& out, const report& rep)
+{
+   const auto& distributions = rep.distributions;
+   if (distributions.empty()) {
+      return;
+   }
+
+   out << "\n## Value Distributions\n\n";
+   out << "Vectors of " << vector_size << " elements with values drawn from: full range (uniform over the type, as in ";
+   out << "the main vector tests), small (integers below 100 in magnitude, floating point in [0, 1)), zipf (ranks with ";
+   out << "P(k) ~ 1/k^1.1, as for popular IDs), monotonic (sorted timestamps with small random steps) and sparse zero ";
+   out << "(90% zeros, the rest full range). Signed integers use zig-zag varints (`sint32`/`sint64`) in Protobuf. ";
+   out << "Throughput is Write / Read.\n";
+
+   for (const auto& d : distributions) {
+      out << "\n### " << d.name << "\n\n";
+      write_format_header(out, {"Distribution"});
+      for (const auto& p : d.points) {
+         write_format_row(out, std::string(distribution_name(p.dist)) + " size",
+                          [&](size_t f) { return format_size(p.formats[f].size); });
+      }
+      for (const auto& p : d.points) {
+         write_format_row(out, std::string(distribution_name(p.dist)) + " throughput",
+                          [&](size_t f) { return format_write_read(p.formats[f]); });
+      }
+   }
+}
@@ -0,0 +1,203 @@
+// Schema evolution mode: obj_t decoded from messages written on other versions of its schema (obj_unknown_t,
+// obj_missing_t, obj_reordered_t), with every reader set to skip keys it does not know
+
+#include <iostream>
+#include <numeric>
+
+#include "raw_codec.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr std::array<size_t, 4> evolution_unknown_sizes{1, 16, 256, 4096}; // elements per unknown field
+
+// Glaze rejects unknown keys by default; the same codec reading with error_on_unknown_keys off
+template <class Inner, glz::opts Opts>
+struct skip_unknown_codec
+{
+   static constexpr std::string_view name = Inner::name;
+   static constexpr std::string_view id = Inner::id;
+
+   template <class T>
+   static void encode(const T& value, std::string& out)
+   {
+      Inner::encode(value, out);
+   }
+
+   template <class T>
+   static bool decode(std::string_view in, T& value)
+   {
+      return !glz::read<Opts>(value, in);
+   }
+};
+
+// msgpack-c, msgpack_direct and both protobuf readers skip unknown fields as they are. The raw codec is left out: it
+// has no keys or tags, so it cannot read another schema at all.
+using evolution_codecs =
+   std::tuple<skip_unknown_codec<json_codec, glz::opts{.null_terminated = false, .error_on_unknown_keys = false}>,
+              skip_unknown_codec<beve_codec, glz::opts{.format = glz::BEVE, .error_on_unknown_keys = false}>,
+              msgpack_codec, msgpack_visitor_codec,
+              skip_unknown_codec<glaze_msgpack_codec,
+                                 glz::opts{.format = glz::MSGPACK, .error_on_unknown_keys = false}>,
+              skip_unknown_codec<cbor_codec, glz::opts{.format = glz::CBOR, .error_on_unknown_keys = false}>,
+              protobuf_codec, protobuf_direct_codec>;
+
+// zpp_bits only writes its own pb:: structs, so the Protobuf messages for other schemas come from pb_direct
+template <class Codec>
+using evolution_writer = std::conditional_t<std::same_as<Codec, protobuf_codec>, protobuf_direct_codec, Codec>;
+
+// obj followed by n elements in each unknown field
+obj_unknown_t with_unknown_fields(const obj_t& obj, size_t n)
+{
+   std::vector<double> numbers(n);
+   std::iota(numbers.begin(), numbers.end(), 0.5);
+   return {.fixed_object = obj.fixed_object,
+           .fixed_name_object = obj.fixed_name_object,
+           .another_object = obj.another_object,
+           .string_array = obj.string_array,
+           .string = obj.string,
+           .number = obj.number,
+           .boolean = obj.boolean,
+           .another_bool = obj.another_bool,
+           .extra_integer = -1'000'003 * int64_t(n),
+           .extra_number = 0.25 * double(n),
+           .extra_string = std::string(n, 'x'),
+           .extra_numbers = std::move(numbers),
+           .extra_strings = std::vector<std::string>(n, "unknown"),
+           .extra_objects = std::vector<nested_object_t>(n, obj.another_object.nested_object)};
+}
+
+obj_missing_t without_fields(const obj_t& obj)
+{
+   return {.fixed_object = obj.fixed_object,
+           .fixed_name_object = obj.fixed_name_object,
+           .string = obj.string,
+           .number = obj.number,
+           .boolean = obj.boolean};
+}
+
+obj_reordered_t reordered(const obj_t& obj)
+{
+   return {.another_bool = obj.another_bool,
+           .number = obj.number,
+           .string_array = obj.string_array,
+           .another_object = obj.another_object,
+           .string = obj.string,
+           .boolean = obj.boolean,
+           .fixed_name_object = obj.fixed_name_object,
+           .fixed_object = obj.fixed_object};
+}
+
+// Field by field, through the raw encoding of both
+bool same_obj(const obj_t& a, const obj_t& b)
+{
+   std::string x{};
+   std::string y{};
+   raw_codec::encode(a, x);
+   raw_codec::encode(b, y);
+   return x == y;
+}
+
+template <class Codec, class Message>
+evolution_point run_evolution(std::string_view variant, const Message& message, const obj_t& expected)
+{
+   evolution_point p{variant};
+   std::string buffer{};
+   evolution_writer<Codec>::encode(message, buffer);
+   p.size = buffer.size();
+   obj_t dst{};
+   p.ok = Codec::decode(buffer, dst) && same_obj(dst, expected);
+   if (p.ok) {
+      p.read = measure_for([&] { Codec::decode(buffer, dst); });
+   }
+   else {
+      std::cerr << Codec::name << " " << variant << " error!\n";
+   }
+   return p;
+}
+
+} // namespace
+
+std::vector<evolution_result> evolution_test()
+{
+   const auto obj = make_obj();
+   auto trimmed = obj; // what a reader holds after decoding obj_missing_t
+   trimmed.another_object = {};
+   trimmed.string_array = {};
+   trimmed.another_bool = false;
+
+   std::vector<evolution_result> results;
+   const auto run = [&](auto c) {
+      using C = decltype(c);
+      std::cout << "  " << C::name << "\n";
+      auto& r = results.emplace_back(std::string(C::name));
+      r.points.push_back(run_evolution<C>("Same schema", obj, obj));
+      r.points.push_back(run_evolution<C>("Reordered keys", reordered(obj), obj));
+      r.points.push_back(run_evolution<C>("Missing fields", without_fields(obj), trimmed));
+      for (const auto n : evolution_unknown_sizes) {
+         r.points.push_back(run_evolution<C>("Unknown fields", with_unknown_fields(obj, n), obj));
+         r.points.back().unknown = n;
+      }
+   };
+   std::apply([&](auto... c) { (run(c), ...); }, evolution_codecs{});
+   return results;
+}
+
+void write_evolution_section(std::ostream& out, const report& rep)
+{
+   const auto& evolution = rep.evolution;
+   if (evolution.empty()) {
+      return;
+   }
+
+   out << "\n## Schema Evolution\n\n";
+   out << "The Complex Nested Object read into `obj_t` from messages written on other versions of its schema: its ";
+   out << "keys in a different order, without `another_object`, `string_array` and `another_bool`, and followed by ";
+   out << "six fields the reader does not know (an integer, a double, a string, and vectors of doubles, strings and ";
+   out << "`nested_object_t`). Glaze reads with `error_on_unknown_keys = false`; the msgpack-c and Protobuf readers ";
+   out << "skip unknown fields as they are. Protobuf messages for the other schemas are written by Protobuf Direct ";
+   out << "with the field numbers of `obj_t`. Reads reuse the destination and are timed for "
+       << measure_defaults.target_seconds << " s. The raw struct codec has no keys and cannot read another schema.\n\n";
+
+   out << "Read time per message, and relative to the same schema:\n\n";
+   out << "| Codec | Same Schema | Reordered Keys | Missing Fields |\n";
+   out << "|-------|-------------|----------------|----------------|\n";
+   for (const auto& e : evolution) {
+      const auto& same = e.points[0];
+      out << "| " << e.codec << " | " << (same.ok ? format_time(same.read.median()) : "error") << " |";
+      for (size_t i = 1; i < 3; ++i) {
+         const auto& p = e.points[i];
+         if (!p.ok || !same.ok) {
+            out << " error |";
+            continue;
+         }
+         out << " " << format_time(p.read.median()) << " (" << format_speedup(p.read, same.read) << ") |";
+      }
+      out << "\n";
+   }
+
+   out << "\nUnknown fields: Unknown Data is the growth of the message over the same schema, Extra Time the growth ";
+   out << "of the read time, and Skip Rate the unknown data over the extra time.\n\n";
+   out << "| Codec | Elements per Field | Message Size | Unknown Data | Read Time | Extra Time | Skip Rate |\n";
+   out << "|-------|--------------------|--------------|--------------|-----------|------------|-----------|\n";
+   for (const auto& e : evolution) {
+      const auto& same = e.points[0];
+      for (size_t i = 3; i < e.points.size(); ++i) {
+         const auto& p = e.points[i];
+         out << "| " << e.codec << " | " << p.unknown << " | " << format_size(p.size) << " | ";
+         if (!p.ok || !same.ok) {
+            out << "| error | | |\n";
+            continue;
+         }
+         const auto unknown = p.size > same.size ? p.size - same.size : 0;
+         const auto extra = p.read.median() - same.read.median();
+         out << format_size(unknown) << " | " << format_time(p.read.median()) << " | "
+             << (extra > 0 ? format_time(extra) : "n/a") << " | "
+             << (extra > 0 ? format_throughput(unknown, extra) : "n/a") << " |\n";
+      }
+   }
+}
@@ -0,0 +1,183 @@
+// Payload families mode: log lines, metric bags, event unions and sparse records of 10 to N entries through every
+// format, reported with the vector tests
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr std::string_view string_length_name(string_length l)
+{
+   switch (l) {
+   case string_length::short_words:
+      return "4-12 char";
+   case string_length::log_lines:
+      return "log-normal ~80 char";
+   case string_length::uniform:
+      return "0-256 char";
+   case string_length::long_text:
+      return "1-4 KB";
+   }
+   return "unknown";
+}
+
+// Printable text without characters that JSON escapes
+std::string random_text(std::mt19937_64& gen, string_length l)
+{
+   size_t n{};
+   switch (l) {
+   case string_length::short_words:
+      n = std::uniform_int_distribution<size_t>{4, 12}(gen);
+      break;
+   case string_length::log_lines:
+      n = std::clamp(size_t(std::lognormal_distribution<double>{std::log(80.0), 0.5}(gen)), size_t(16), size_t(1024));
+      break;
+   case string_length::uniform:
+      n = std::uniform_int_distribution<size_t>{0, 256}(gen);
+      break;
+   case string_length::long_text:
+      n = std::uniform_int_distribution<size_t>{1024, 4096}(gen);
+      break;
+   }
+   static constexpr std::string_view alphabet = "abcdefghijklmnopqrstuvwxyz0123456789 .:=/-_";
+   std::string s(n, ' ');
+   for (auto& c : s) {
+      c = alphabet[gen() % alphabet.size()];
+   }
+   return s;
+}
+
+std::vector<std::string> random_lines(size_t n, string_length l)
+{
+   std::mt19937_64 gen{};
+   std::vector<std::string> lines(n);
+   for (auto& line : lines) {
+      line = random_text(gen, l);
+   }
+   return lines;
+}
+
+// The index keeps the keys distinct
+std::map<std::string, double> random_metrics(size_t n, string_length l)
+{
+   std::mt19937_64 gen{};
+   std::uniform_real_distribution<double> value{-1e6, 1e6};
+   std::map<std::string, double> metrics;
+   for (size_t i = 0; i < n; ++i) {
+      metrics.emplace(random_text(gen, l) + "#" + std::to_string(i), value(gen));
+   }
+   return metrics;
+}
+
+std::vector<event_t> random_events(size_t n, string_length l)
+{
+   std::mt19937_64 gen{};
+   std::vector<event_t> events;
+   events.reserve(n);
+   uint64_t timestamp = 1'700'000'000'000;
+   for (size_t i = 0; i < n; ++i) {
+      timestamp += gen() % 1000;
+      switch (gen() % 3) {
+      case 0:
+         events.push_back(login_event_t{random_text(gen, l), timestamp, bool(gen() & 1)});
+         break;
+      case 1:
+         events.push_back(metric_event_t{random_text(gen, l), std::uniform_real_distribution<double>{0, 100}(gen),
+                                         timestamp});
+         break;
+      default: {
+         error_event_t error{int32_t(gen() % 1000) - 500, random_text(gen, l), {}};
+         error.stack.resize(gen() % 5);
+         for (auto& frame : error.stack) {
+            frame = random_text(gen, l);
+         }
+         events.push_back(std::move(error));
+         break;
+      }
+      }
+   }
+   return events;
+}
+
+// Each optional field is present in one record out of five, and never zero or empty when present
+std::vector<sparse_record_t> random_sparse_records(size_t n, string_length l)
+{
+   std::mt19937_64 gen{};
+   const auto present = [&] { return gen() % 5 == 0; };
+   const auto real = [&] { return std::uniform_real_distribution<double>{1.0, 1000.0}(gen); };
+   const auto count = [&] { return int64_t(gen() % 10'000) + 1; };
+   const auto text = [&] {
+      auto s = random_text(gen, l);
+      return s.empty() ? std::string("-") : s;
+   };
+   std::vector<sparse_record_t> records(n);
+   for (size_t i = 0; i < n; ++i) {
+      auto& r = records[i];
+      r.id = i + 1;
+      for (auto* v : {&r.temperature, &r.pressure, &r.humidity, &r.wind_speed}) {
+         if (present()) {
+            *v = real();
+         }
+      }
+      for (auto* v : {&r.error_count, &r.retry_count}) {
+         if (present()) {
+            *v = count();
+         }
+      }
+      if (present()) {
+         r.status = uint32_t(count());
+      }
+      for (auto* v : {&r.host, &r.region, &r.note}) {
+         if (present()) {
+            *v = text();
+         }
+      }
+   }
+   return records;
+}
+
+// 10 to max_entries in steps of 10x
+std::vector<size_t> family_sizes(size_t max_entries)
+{
+   std::vector<size_t> sizes;
+   for (size_t n = 10; n < max_entries; n *= 10) {
+      sizes.push_back(n);
+   }
+   sizes.push_back(max_entries);
+   return sizes;
+}
+
+template <class T>
+benchmark_result family_result(std::string name, const T& value)
+{
+   return {std::move(name), run_formats(value)};
+}
+
+} // namespace
+
+std::vector<benchmark_result> family_test(size_t max_entries, const std::vector<string_length>& lengths)
+{
+   std::vector<benchmark_result> results;
+   for (const auto l : lengths) {
+      for (const auto n : family_sizes(max_entries)) {
+         const auto suffix = " (" + std::to_string(n) + ", " + std::string(string_length_name(l)) + " strings)";
+         std::cout << "Testing: payload families" << suffix << "\n";
+         results.push_back(family_result("std::vector<std::string>" + suffix, random_lines(n, l)));
+         const auto metrics = random_metrics(n, l);
+         results.push_back(family_result("std::map<std::string, double>" + suffix, metrics));
+         results.push_back(family_result("std::unordered_map<std::string, double>" + suffix,
+                                         std::unordered_map<std::string, double>(metrics.begin(), metrics.end())));
+         results.push_back(family_result("std::vector<event_t>" + suffix, random_events(n, l)));
+         results.push_back(family_result("std::vector<sparse_record_t>" + suffix, random_sparse_records(n, l)));
+      }
+   }
+   return results;
+}
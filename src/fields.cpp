@@ -0,0 +1,220 @@
+// Selective field access: a router only needs `number` or `another_object.nested_object.id`. Each *_field_bench
+// extracts one of them by path from the buffer written by its format's codec without decoding the rest of the
+// message. CBOR is left out because Glaze has no partial CBOR read.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+struct json_field_bench
+{
+   using codec = json_codec;
+
+   codec_bench<codec, obj_t> source;
+   double number{};
+   std::string_view id{};
+
+   // JSON pointer lookups: Glaze skips over every value before the target without parsing it
+   bool read_number()
+   {
+      const auto value = glz::get_as_json<double, "/number">(source.buffer);
+      if (!value) {
+         return false;
+      }
+      number = *value;
+      return true;
+   }
+
+   bool read_id()
+   {
+      const auto value = glz::get_as_json<std::string_view, "/another_object/nested_object/id">(source.buffer);
+      if (!value) {
+         return false;
+      }
+      id = *value;
+      return true;
+   }
+};
+
+struct beve_field_bench
+{
+   using codec = beve_codec;
+
+   codec_bench<codec, obj_t> source;
+   double number{};
+   std::string_view id{};
+
+   bool read_number()
+   {
+      beve::cursor c{source.buffer};
+      if (!beve::find(c, {"number"})) {
+         return false;
+      }
+      number = c.number<double>();
+      return c.ok;
+   }
+
+   bool read_id()
+   {
+      beve::cursor c{source.buffer};
+      if (!beve::find(c, {"another_object", "nested_object", "id"})) {
+         return false;
+      }
+      id = c.string();
+      return c.ok;
+   }
+};
+
+// msgpack-c has no lazy reader, so a lookup still unpacks the whole object tree (without copying strings)
+struct msgpack_field_bench
+{
+   using codec = msgpack_codec;
+
+   codec_bench<codec, obj_t> source;
+   msgpack::object_handle oh{};
+   double number{};
+   std::string_view id{};
+
+   bool read_number()
+   {
+      oh = msgpack::unpack(source.buffer.data(), source.buffer.size(), msgpack_view::reference_all);
+      const auto* value = msgpack_view::find(oh.get(), {"number"});
+      return value && msgpack_view::read_view(*value, number);
+   }
+
+   bool read_id()
+   {
+      oh = msgpack::unpack(source.buffer.data(), source.buffer.size(), msgpack_view::reference_all);
+      const auto* value = msgpack_view::find(oh.get(), {"another_object", "nested_object", "id"});
+      return value && msgpack_view::read_view(*value, id);
+   }
+};
+
+// zpp_bits only decodes whole messages, so the lookup walks the wire format with pb_wire. Field numbers follow the
+// member order of pb::obj_t (number = 6, another_object = 3), pb::another_object_t (nested_object = 4) and
+// pb::nested_object_t (id = 2).
+struct protobuf_field_bench
+{
+   using codec = protobuf_codec;
+
+   codec_bench<codec, obj_t> source;
+   double number{};
+   std::string_view id{};
+
+   bool read_number()
+   {
+      pb_wire::cursor c{source.bytes()};
+      pb_wire::wire_type type{};
+      if (!pb_wire::find(c, {6}, type)) {
+         return false;
+      }
+      pb_wire::read_view(c, type, number);
+      return c.ok;
+   }
+
+   bool read_id()
+   {
+      pb_wire::cursor c{source.bytes()};
+      pb_wire::wire_type type{};
+      if (!pb_wire::find(c, {3, 4, 2}, type)) {
+         return false;
+      }
+      pb_wire::read_view(c, type, id);
+      return c.ok;
+   }
+};
+
+template <class Bench>
+void run_field_access(const obj_t& obj, field_point& p)
+{
+   using C = typename Bench::codec;
+   Bench bench{codec_bench<C, obj_t>{obj}};
+
+   if (!bench.source.read() || !bench.read_number() || !bench.read_id() || bench.number != obj.number ||
+       bench.id != obj.another_object.nested_object.id) {
+      std::cerr << C::name << " field access error!\n";
+      return;
+   }
+   auto& r = p.formats[format_index<C>].emplace();
+   r.size = bench.source.size();
+   r.full = measure_for([&] { bench.source.read(); });
+   r.number = measure_for([&] { bench.read_number(); });
+   r.id = measure_for([&] { bench.read_id(); });
+}
+
+// Time to extract a field, with its share of the full decode time
+std::string format_field_time(const measurement& m, const measurement& full)
+{
+   std::ostringstream oss;
+   oss << format_time(m.median());
+   if (full.median() > 0) {
+      oss << " (" << std::fixed << std::setprecision(m.median() < 0.01 * full.median() ? 2 : 1)
+          << (100.0 * m.median() / full.median()) << "%)";
+   }
+   return oss.str();
+}
+
+} // namespace
+
+// Array lengths from 10 up to max_elements in steps of 10x
+std::vector<field_point> field_access_test(size_t max_elements)
+{
+   std::vector<size_t> sizes;
+   for (size_t n = 10; n < max_elements; n *= 10) {
+      sizes.push_back(n);
+   }
+   sizes.push_back(max_elements);
+
+   std::vector<field_point> points;
+   for (auto n : sizes) {
+      std::cout << "  arrays x " << n << "\n";
+      const auto obj = scaled_obj(n);
+      auto& p = points.emplace_back(field_point{n, {}});
+      run_field_access<json_field_bench>(obj, p);
+      run_field_access<beve_field_bench>(obj, p);
+      run_field_access<msgpack_field_bench>(obj, p);
+      run_field_access<protobuf_field_bench>(obj, p);
+   }
+   return points;
+}
+
+void write_field_section(std::ostream& out, const report& rep)
+{
+   const auto& points = rep.fields;
+   if (points.empty()) {
+      return;
+   }
+
+   out << "\n## Selective Field Access\n\n";
+   out << "Time to extract a single field by path from the Complex Nested Object, with every array ";
+   out << "(`int_array`, `float_array`, `double_array`, `v3s` and `string_array`) grown to the given length. ";
+   out << "JSON uses Glaze JSON pointer reads (`glz::get_as_json`), BEVE and Protobuf walk the buffer and skip ";
+   out << "unrelated values, and MessagePack unpacks the msgpack-c object tree (strings referenced) and looks up ";
+   out << "map keys. ";
+   out << "Percentages are relative to the full decode of the same buffer into `obj_t`. ";
+   out << "CBOR is n/a because Glaze has no partial CBOR read.\n";
+
+   const auto write_table = [&](std::string_view title, auto&& cell) {
+      out << "\n### " << title << "\n\n";
+      write_format_header(out, {"Elements"});
+      for (const auto& p : points) {
+         write_format_row(out, std::to_string(p.elements), [&](size_t f) {
+            const auto& a = p.formats[f];
+            return a ? cell(*a) : "n/a";
+         });
+      }
+   };
+   write_table("Full Decode (message size)", [](const field_access& f) {
+      return format_time(f.full.median()) + " (" + format_size(f.size) + ")";
+   });
+   write_table("Time to `number`", [](const field_access& f) { return format_field_time(f.number, f.full); });
+   write_table("Time to `another_object.nested_object.id`",
+               [](const field_access& f) { return format_field_time(f.id, f.full); });
+}
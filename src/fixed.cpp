@@ -0,0 +1,168 @@
+// Fixed tests: the complex object and the 10K element vectors through every format, each with the raw struct floor
+// and the memory bandwidth roofline, plus the Protobuf and MessagePack alternatives on the complex object
+
+#include <iostream>
+#include <string>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+// Every format and the raw floor on one value, with the copy roofline on each message size
+template <class T>
+void add_result(report& rep, std::string name, const T& value)
+{
+   const auto& r = rep.results.emplace_back(benchmark_result{std::move(name), run_formats(value)});
+   roofline_result roof{};
+   roof.raw = run_codec<raw_struct_codec>(value);
+   roof.raw_copy = run_roofline(roof.raw.size);
+   for (size_t f = 0; f < format_count; ++f) {
+      roof.formats[f] = run_roofline(r.formats[f].size);
+   }
+   rep.roofline.push_back(roof);
+}
+
+// The direct codec must read what zpp_bits writes from the pb:: structs, and zpp_bits what the direct codec writes
+results protobuf_direct_test(const obj_t& obj)
+{
+   codec_bench<protobuf_codec, obj_t> zpp{obj};
+   codec_bench<protobuf_direct_codec, obj_t> direct{obj};
+   if (!direct.read(zpp.bytes()) || !zpp.read(direct.bytes())) {
+      std::cerr << protobuf_direct_codec::name << " is not wire compatible with zpp_bits!\n";
+   }
+   std::string reencoded{};
+   protobuf_direct_codec::encode(zpp.dst, reencoded);
+   if (reencoded != direct.buffer) {
+      std::cerr << protobuf_direct_codec::name << " round trip through zpp_bits changed the message!\n";
+   }
+   return run_bench(direct, protobuf_direct_codec::name);
+}
+
+msgpack_strategy_result msgpack_strategy_test(const obj_t& obj)
+{
+   // Whatever the visitor decodes must pack back to the bytes it was given
+   codec_bench<msgpack_visitor_codec, obj_t> visitor{obj};
+   std::string repacked{};
+   if (!visitor.read()) {
+      std::cerr << msgpack_visitor_codec::name << " cannot read msgpack-c output!\n";
+   }
+   msgpack_codec::encode(visitor.dst, repacked);
+   if (repacked != visitor.buffer) {
+      std::cerr << msgpack_visitor_codec::name << " round trip through msgpack-c changed the message!\n";
+   }
+   return std::apply([&](auto... c) { return msgpack_strategy_result{run_codec<decltype(c)>(obj)...}; },
+                     msgpack_strategies{});
+}
+
+} // namespace
+
+void fixed_tests(report& rep)
+{
+   const auto obj = make_obj();
+   std::cout << "Testing: Complex Nested Object\n";
+   add_result(rep, "Complex Nested Object", obj);
+
+   std::cout << "Testing: Complex Nested Object (protobuf without conversion)\n";
+   rep.protobuf_direct = protobuf_direct_test(obj);
+
+   std::cout << "Testing: Complex Nested Object (MessagePack decoding strategies)\n";
+   rep.msgpack_strategies = msgpack_strategy_test(obj);
+
+   std::cout << "Testing: Complex Nested Object (zero-copy views)\n";
+   rep.views = view_test();
+
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      std::cout << "Testing: std::vector<" << type << "> (10,000 elements)\n";
+      add_result(rep, "std::vector<" + std::string(type) + "> (10K)", random_vector<T>());
+   });
+}
+
+void write_roofline_section(std::ostream& out, const report& rep)
+{
+   if (rep.roofline.empty()) {
+      return;
+   }
+   out << "\n## Memory Bandwidth Roofline\n\n";
+   out << "Every codec at least reads its input and writes its output once, so a plain copy of the encoded bytes bounds ";
+   out << "its throughput. For each format the roofline is the faster of `memcpy` and a non-temporal streaming copy ";
+   out << "(`roofline.hpp`) of that format's message size, and the percentages below are its Write / Read throughput ";
+   out << "relative to it. The raw struct codec (`raw_codec.hpp`) writes the members in declaration order with only ";
+   out << "length prefixes, no keys, tags or type information, as the floor for a structured format. The copy ";
+   out << "throughput columns are measured on the raw codec's size.\n\n";
+   write_format_header(out, {"Test", "memcpy", "Streaming Copy", "Raw Struct Size", "Raw Struct Write / Read",
+                             "Raw Struct"});
+   for (size_t i = 0; i < rep.results.size() && i < rep.roofline.size(); ++i) {
+      const auto& r = rep.results[i];
+      const auto& roof = rep.roofline[i];
+      const auto label = r.name + " | " + format_throughput(roof.raw.size, roof.raw_copy.copy) + " | " +
+                         format_throughput(roof.raw.size, roof.raw_copy.stream) + " | " +
+                         format_size(roof.raw.size) + " | " + format_throughput(roof.raw.size, roof.raw.write) +
+                         " / " + format_throughput(roof.raw.size, roof.raw.read) + " | " +
+                         format_roofline(roof.raw, roof.raw_copy);
+      write_format_row(out, label, [&](size_t f) { return format_roofline(r.formats[f], roof.formats[f]); });
+   }
+}
+
+void write_protobuf_direct_section(std::ostream& out, const report& rep)
+{
+   if (!rep.protobuf_direct || rep.results.empty()) {
+      return;
+   }
+   const auto& conv = rep.results.front().formats[format_index<protobuf_codec>]; // Complex Nested Object
+   const auto& direct = *rep.protobuf_direct;
+
+   out << "\n## Protobuf With and Without Conversion\n\n";
+   out << "The Protobuf column elsewhere converts `obj_t` to and from the `pb::` shadow structs inside the timed loop ";
+   out << "and lets zpp_bits encode those. The direct codec encodes and decodes `obj_t` itself through a field-number ";
+   out << "table (`pb_direct.hpp`), producing the same wire format, so the difference is the cost of the conversion.\n\n";
+   out << "| Metric | With Conversion | Direct | Speedup |\n";
+   out << "|--------|-----------------|--------|---------|\n";
+   out << "| Message Size | " << format_size(conv.size) << " | " << format_size(direct.size) << " | |\n";
+   out << "| Write Throughput | " << format_throughput(conv.size, conv.write) << " | "
+       << format_throughput(direct.size, direct.write) << " | " << format_speedup(conv.write, direct.write) << " |\n";
+   out << "| Read Throughput | " << format_throughput(conv.size, conv.read) << " | "
+       << format_throughput(direct.size, direct.read) << " | " << format_speedup(conv.read, direct.read) << " |\n";
+   out << "| Fresh Read Throughput | " << format_throughput(conv.size, conv.read_fresh) << " | "
+       << format_throughput(direct.size, direct.read_fresh) << " | "
+       << format_speedup(conv.read_fresh, direct.read_fresh) << " |\n";
+   out << "| Write Allocations | " << format_allocs(conv.write) << " | " << format_allocs(direct.write) << " | |\n";
+   out << "| Read Allocations | " << format_allocs(conv.read) << " | " << format_allocs(direct.read) << " | |\n";
+}
+
+void write_msgpack_strategy_section(std::ostream& out, const report& rep)
+{
+   if (!rep.msgpack_strategies || rep.results.empty()) {
+      return;
+   }
+   const auto& full = rep.results.front().formats; // Complex Nested Object
+   const auto& m = *rep.msgpack_strategies;
+   const auto& beve = full[format_index<beve_codec>];
+   const std::array<const results*, 5> columns{&full[format_index<msgpack_codec>], &m[0], &m[1], &m[2], &beve};
+
+   out << "\n## MessagePack Decoding Strategies\n\n";
+   out << "The same `obj_t` through MessagePack four ways, with BEVE for reference. msgpack-c's usual path unpacks into ";
+   out << "a fresh zone-allocated object tree and then `convert`s it; \"zone reuse\" unpacks into one long-lived zone ";
+   out << "with strings referenced; the visitor drives `msgpack::parse` straight into `obj_t` through its field table ";
+   out << "(`msgpack_direct.hpp`) with no tree at all; Glaze MessagePack is Glaze's own reader and writer. If the ";
+   out << "visitor and Glaze close the gap to BEVE, the gap comes from the decoding strategy rather than the format.\n\n";
+   out << "| Metric | msgpack-c (unpack + convert) | msgpack-c (zone reuse) | msgpack-c (visitor) | Glaze MessagePack | "
+          "BEVE |\n";
+   out << "|--------|------------------------------|------------------------|---------------------|-------------------|"
+          "------|\n";
+   const auto row = [&](std::string_view metric, auto&& cell) {
+      out << "| " << metric << " | ";
+      for (const auto* r : columns) {
+         out << cell(*r) << " | ";
+      }
+      out << "\n";
+   };
+   row("Message Size", [](const results& r) { return format_size(r.size); });
+   row("Write Throughput", [](const results& r) { return format_throughput(r.size, r.write); });
+   row("Read Throughput", [](const results& r) { return format_throughput(r.size, r.read); });
+   row("Fresh Read Throughput", [](const results& r) { return format_throughput(r.size, r.read_fresh); });
+   row("Read Time vs BEVE", [&](const results& r) { return format_speedup(r.read, beve.read); });
+   row("Read Allocations", [](const results& r) { return format_allocs(r.read); });
+}
@@ -0,0 +1,166 @@
+#include "format.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+std::string format_time(double seconds)
+{
+   std::ostringstream oss;
+   if (seconds < 1e-6) {
+      oss << std::fixed << std::setprecision(1) << (seconds * 1e9) << " ns";
+   }
+   else if (seconds < 0.001) {
+      oss << std::fixed << std::setprecision(2) << (seconds * 1e6) << " µs";
+   }
+   else if (seconds < 1.0) {
+      oss << std::fixed << std::setprecision(2) << (seconds * 1e3) << " ms";
+   }
+   else {
+      oss << std::fixed << std::setprecision(3) << seconds << " s";
+   }
+   return oss.str();
+}
+
+std::string format_size(uint64_t bytes)
+{
+   std::ostringstream oss;
+   if (bytes < 1024) {
+      oss << bytes << " B";
+   }
+   else if (bytes < 1024 * 1024) {
+      oss << std::fixed << std::setprecision(2) << (bytes / 1024.0) << " KB";
+   }
+   else {
+      oss << std::fixed << std::setprecision(2) << (bytes / (1024.0 * 1024.0)) << " MB";
+   }
+   return oss.str();
+}
+
+std::string format_speedup(double baseline, double compared)
+{
+   std::ostringstream oss;
+   double speedup = baseline / compared;
+   oss << std::fixed << std::setprecision(1) << speedup << "x";
+   return oss.str();
+}
+
+std::string format_speedup(const measurement& baseline, const measurement& compared)
+{
+   return format_speedup(baseline.median(), compared.median());
+}
+
+std::string format_throughput(uint64_t size, double seconds)
+{
+   std::ostringstream oss;
+   double bytes_per_sec = size / seconds;
+   if (bytes_per_sec >= 1e9) {
+      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e9) << " GB/s";
+   }
+   else if (bytes_per_sec >= 1e6) {
+      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e6) << " MB/s";
+   }
+   else {
+      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e3) << " KB/s";
+   }
+   return oss.str();
+}
+
+std::string format_throughput(uint64_t size, const measurement& m)
+{
+   std::ostringstream oss;
+   oss << format_throughput(size, m.median());
+   if (m.median() > 0.0) {
+      oss << " ±" << std::fixed << std::setprecision(1) << (100.0 * m.ci95() / m.median()) << "%";
+   }
+   return oss.str();
+}
+
+std::string format_allocs(const measurement& m)
+{
+   if (m.operations == 0) {
+      return "n/a";
+   }
+   const auto ops = double(m.operations);
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(1) << (double(m.allocs.allocations) / ops) << " / "
+       << format_size(uint64_t(std::llround(double(m.allocs.bytes) / ops)));
+   return oss.str();
+}
+
+std::string format_latency(const measurement& m)
+{
+   const auto& h = m.latency;
+   return format_time(double(h.total ? h.min : 0) * 1e-9) + " / " + format_time(h.percentile(0.5) * 1e-9) + " / " +
+          format_time(h.percentile(0.99) * 1e-9) + " / " + format_time(h.percentile(0.999) * 1e-9);
+}
+
+std::string format_counter(const std::optional<double>& total, const measurement& m, uint64_t size)
+{
+   if (!total || m.operations == 0 || size == 0) {
+      return "n/a";
+   }
+   const auto per_msg = *total / double(m.operations);
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(per_msg < 100.0 ? 2 : 0) << per_msg << " / " << std::setprecision(3)
+       << (per_msg / double(size));
+   return oss.str();
+}
+
+std::string format_ipc(const measurement& m)
+{
+   const auto& c = m.counters;
+   if (!c.cycles || !c.instructions || *c.cycles == 0.0) {
+      return "n/a";
+   }
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(2) << (*c.instructions / *c.cycles);
+   return oss.str();
+}
+
+std::string format_roofline(const measurement& m, const roofline_point& p)
+{
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(1) << (100.0 * p.best() / m.median()) << "%";
+   return oss.str();
+}
+
+std::string format_roofline(const results& r, const roofline_point& p)
+{
+   return format_roofline(r.write, p) + " / " + format_roofline(r.read, p);
+}
+
+std::string format_write_read(const results& r)
+{
+   return format_throughput(r.size, r.write.median()) + " / " + format_throughput(r.size, r.read.median());
+}
+
+std::string format_stream_rate(size_t records, uint64_t bytes, double seconds)
+{
+   if (seconds <= 0) {
+      return "n/a";
+   }
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(0) << (double(bytes) / seconds / 1e6) << " MB/s, ";
+   oss << std::setprecision(2) << (double(records) / seconds / 1e6) << "M rec/s";
+   return oss.str();
+}
+
+void write_format_header(std::ostream& out, std::initializer_list<std::string_view> leading)
+{
+   out << "|";
+   for (const auto label : leading) {
+      out << " " << label << " |";
+   }
+   for (const auto name : format_names) {
+      out << " " << name << " |";
+   }
+   out << "\n|";
+   for (const auto label : leading) {
+      out << std::string(label.size() + 2, '-') << "|";
+   }
+   for (const auto name : format_names) {
+      out << std::string(name.size() + 2, '-') << "|";
+   }
+   out << "\n";
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "bench.hpp"
+
+// Table cells shared by the report sections
+
+std::string format_time(double seconds);
+std::string format_size(uint64_t bytes);
+std::string format_speedup(double baseline, double compared);
+
+// Speedup from the median per-operation time of each measurement
+std::string format_speedup(const measurement& baseline, const measurement& compared);
+
+std::string format_throughput(uint64_t size, double seconds);
+
+// Median throughput across trials, with the 95% confidence interval of the median as a relative error
+std::string format_throughput(uint64_t size, const measurement& m);
+
+// Heap allocations and requested bytes per operation
+std::string format_allocs(const measurement& m);
+
+// min / p50 / p99 / p99.9 of the sampled per-operation latencies
+std::string format_latency(const measurement& m);
+
+// Counter total expressed per message and per byte, e.g. "1234 / 2.188"
+std::string format_counter(const std::optional<double>& total, const measurement& m, uint64_t size);
+
+std::string format_ipc(const measurement& m);
+
+// Throughput as a percentage of the faster copy kernel on the same byte count
+std::string format_roofline(const measurement& m, const roofline_point& p);
+std::string format_roofline(const results& r, const roofline_point& p);
+
+// Median write / read throughput without the confidence interval, for dense tables
+std::string format_write_read(const results& r);
+
+// Sustained file throughput: MB/s of log bytes and records per second
+std::string format_stream_rate(size_t records, uint64_t bytes, double seconds);
+
+// "| <leading> | JSON | BEVE | ... |" with a column per format, and its separator row
+void write_format_header(std::ostream& out, std::initializer_list<std::string_view> leading);
+
+// One table row: the label (which may span several leading columns) and cell(f) for each format index f
+template <class Cell>
+void write_format_row(std::ostream& out, std::string_view label, Cell&& cell)
+{
+   out << "| " << label << " |";
+   for (size_t f = 0; f < format_count; ++f) {
+      out << " " << cell(f) << " |";
+   }
+   out << "\n";
+}
@@ -0,0 +1,52 @@
+// Layout mode: the same random point cloud as points_aos_t and points_soa_t through every format
+
+#include <iostream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+// Point counts from 10 up to max_points in steps of 10x
+std::vector<layout_point> layout_test(size_t max_points)
+{
+   std::vector<layout_point> points;
+   for (size_t n = 10; n <= max_points; n *= 10) {
+      std::cout << "  " << n << " points\n";
+      const auto aos = random_points(n);
+      const auto soa = to_soa(aos);
+      const auto run = [&](auto c) {
+         using C = decltype(c);
+         return layout_pair{run_codec<C>(aos), run_codec<C>(soa)};
+      };
+      points.push_back({n, map_formats(run)});
+   }
+   return points;
+}
+
+void write_layout_section(std::ostream& out, const report& rep)
+{
+   const auto& layouts = rep.layouts;
+   if (layouts.empty()) {
+      return;
+   }
+
+   out << "\n## Point Cloud Layout: Array of Structs vs Struct of Arrays\n\n";
+   out << "The same random points as `std::vector<std::array<double, 3>>` (AoS, the layout of ";
+   out << "`nested_object_t::v3s`; a repeated `vec3` message in Protobuf) and as three `std::vector<double>` ";
+   out << "(SoA; packed repeated doubles in Protobuf, typed arrays in BEVE and CBOR). Throughput is Write / Read; ";
+   out << "the speedup is AoS time over SoA time for the same points.\n\n";
+   write_format_header(out, {"Points", "Metric"});
+   for (const auto& p : layouts) {
+      const auto row = [&](std::string_view metric, auto&& cell) {
+         write_format_row(out, std::to_string(p.points) + " | " + std::string(metric),
+                          [&](size_t f) { return cell(p.formats[f]); });
+      };
+      row("AoS Size", [](const layout_pair& f) { return format_size(f.aos.size); });
+      row("SoA Size", [](const layout_pair& f) { return format_size(f.soa.size); });
+      row("AoS Throughput", [](const layout_pair& f) { return format_write_read(f.aos); });
+      row("SoA Throughput", [](const layout_pair& f) { return format_write_read(f.soa); });
+      row("SoA Speedup", [](const layout_pair& f) {
+         return format_speedup(f.aos.write, f.soa.write) + " / " + format_speedup(f.aos.read, f.soa.read);
+      });
+   }
+}
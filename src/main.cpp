@@ -1,805 +1,358 @@
+// Command line driver: parses the options, runs the selected modes and writes results.md, results.json and
+// sweep.csv
 
-#include <limits>
-#include <type_traits>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstdlib>
 #include <iomanip>
-#include <ctime>
 #include <iostream>
-#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include "glaze/glaze.hpp"
-#include "glaze/beve.hpp"
-#include "glaze/cbor.hpp"
-#include "glaze/glaze_exceptions.hpp"
-#include "glaze/exceptions/binary_exceptions.hpp"
+#include "cache_info.hpp"
+#include "measure.hpp"
+#include "scaling.hpp"
 
-#define MSGPACK_NO_BOOST
-#include "msgpack.hpp"
+#include "format.hpp"
+#include "report.hpp"
 
-#include "zpp_bits.h"
-
-static constexpr std::string_view json0 = R"(
-{
-   "fixed_object": {
-      "int_array": [0, 1, 2, 3, 4, 5, 6],
-      "float_array": [0.1, 0.2, 0.3, 0.4, 0.5, 0.6],
-      "double_array": [3288398.238, 233e22, 289e-1, 0.928759872, 0.22222848, 0.1, 0.2, 0.3, 0.4]
-   },
-   "fixed_name_object": {
-      "name0": "James",
-      "name1": "Abraham",
-      "name2": "Susan",
-      "name3": "Frank",
-      "name4": "Alicia"
-   },
-   "another_object": {
-      "string": "here is some text",
-      "another_string": "Hello World",
-      "boolean": false,
-      "nested_object": {
-         "v3s": [[0.12345, 0.23456, 0.001345],
-                  [0.3894675, 97.39827, 297.92387],
-                  [18.18, 87.289, 2988.298]],
-         "id": "298728949872"
-      }
-   },
-   "string_array": ["Cat", "Dog", "Elephant", "Tiger"],
-   "string": "Hello world",
-   "number": 3.14,
-   "boolean": true,
-   "another_bool": false
-}
-)";
-
-// Structs for BEVE, MessagePack, CBOR
-struct fixed_object_t
-{
-   std::vector<int> int_array;
-   std::vector<float> float_array;
-   std::vector<double> double_array;
-
-   MSGPACK_DEFINE_MAP(int_array, float_array, double_array);
-};
-
-struct fixed_name_object_t
+namespace
 {
-   std::string name0;
-   std::string name1;
-   std::string name2;
-   std::string name3;
-   std::string name4;
-
-   MSGPACK_DEFINE_MAP(name0, name1, name2, name3, name4);
-};
 
-struct nested_object_t
+struct options
 {
-   std::vector<std::array<double, 3>> v3s;
-   std::string id;
-
-   MSGPACK_DEFINE_MAP(v3s, id);
-};
-
-struct another_object_t
-{
-   std::string string;
-   std::string another_string;
-   bool boolean;
-   nested_object_t nested_object;
-
-   MSGPACK_DEFINE_MAP(string, another_string, boolean, nested_object);
-};
-
-struct obj_t
-{
-   fixed_object_t fixed_object;
-   fixed_name_object_t fixed_name_object;
-   another_object_t another_object;
-   std::vector<std::string> string_array;
-   std::string string;
-   double number;
-   bool boolean;
-   bool another_bool;
-
-   MSGPACK_DEFINE_MAP(fixed_object, fixed_name_object, another_object, string_array, string, number, boolean,
-                      another_bool);
-};
-
-// Protobuf-compatible structs for zpp_bits
-namespace pb {
-
-struct fixed_object_t
-{
-   std::vector<zpp::bits::vsint32_t> int_array;  // signed varint
-   std::vector<float> float_array;               // fixed32
-   std::vector<double> double_array;             // fixed64
-
-   using serialize = zpp::bits::pb_protocol;
+   size_t threads{}; // maximum thread count for the scaling mode, 0 disables it
+   size_t sweep{}; // largest element count for the payload-size sweep, 0 disables it
+   uint64_t cold{}; // buffer pool footprint in bytes for the cache-cold mode, 0 disables it
+   bool shuffle{}; // visit the cold pool in random order
+   size_t varied{}; // distinct payloads for the varied-payload mode, 0 disables it
+   size_t fields{}; // largest array length for the selective field access test, 0 disables it
+   size_t stream{}; // records per log for the streaming file I/O test, 0 disables it
+   size_t pipeline{}; // records per format for the pipelined I/O test, 0 disables it
+   bool uring = true; // use io_uring for the pipelined I/O test where the kernel allows it
+   bool rpc{}; // run the loopback RPC latency test
+   bool arena{}; // run the arena allocation and fixed-buffer write test
+   bool evolution{}; // run the schema evolution test
+   bool validate{}; // run the validate-only test
+   size_t families{}; // largest entry count for the payload families, 0 disables them
+   std::vector<string_length> string_lengths{string_length::log_lines}; // string lengths for the payload families
+   bool prefilter{}; // run the numeric array pre-filter test
+   bool distributions{}; // run the value-distribution matrix for the vector tests
+   bool batch{}; // run the batch test with 1 to 65536 objects per buffer
+   size_t layout{}; // largest point count for the AoS vs SoA layout test, 0 disables it
+   std::vector<std::string> compare{}; // baseline and candidate results.json; compares them instead of benchmarking
+   double threshold = 5.0; // regression threshold for the compare mode, in percent
+   bool matrix{}; // run the codec matrix instead of the fixed tests
+   matrix_filter filter{}; // matrix cells to run
+   bool list{}; // print the matrix codec and payload ids and exit
 };
 
-struct fixed_name_object_t
+// "a,b,c" as {"a", "b", "c"}
+std::vector<std::string> split_list(std::string_view list)
 {
-   std::string name0;
-   std::string name1;
-   std::string name2;
-   std::string name3;
-   std::string name4;
-
-   using serialize = zpp::bits::pb_protocol;
-};
-
-struct vec3 {
-   double x, y, z;
-   using serialize = zpp::bits::pb_protocol;
-};
-
-struct nested_object_t
-{
-   std::vector<vec3> v3s;
-   std::string id;
-
-   using serialize = zpp::bits::pb_protocol;
-};
-
-struct another_object_t
-{
-   std::string string;
-   std::string another_string;
-   bool boolean;
-   nested_object_t nested_object;
-
-   using serialize = zpp::bits::pb_protocol;
-};
-
-struct obj_t
-{
-   fixed_object_t fixed_object;
-   fixed_name_object_t fixed_name_object;
-   another_object_t another_object;
-   std::vector<std::string> string_array;
-   std::string string;
-   double number;
-   bool boolean;
-   bool another_bool;
-
-   using serialize = zpp::bits::pb_protocol;
-};
-
-// Convert from regular structs to protobuf structs
-inline fixed_object_t to_pb(const ::fixed_object_t& src) {
-   fixed_object_t dst;
-   dst.int_array.reserve(src.int_array.size());
-   for (auto v : src.int_array) dst.int_array.push_back(zpp::bits::vsint32_t{v});
-   dst.float_array = src.float_array;
-   dst.double_array = src.double_array;
-   return dst;
-}
-
-inline fixed_name_object_t to_pb(const ::fixed_name_object_t& src) {
-   return {src.name0, src.name1, src.name2, src.name3, src.name4};
-}
-
-inline nested_object_t to_pb(const ::nested_object_t& src) {
-   nested_object_t dst;
-   dst.v3s.reserve(src.v3s.size());
-   for (const auto& arr : src.v3s) {
-      dst.v3s.push_back({arr[0], arr[1], arr[2]});
-   }
-   dst.id = src.id;
-   return dst;
-}
-
-inline another_object_t to_pb(const ::another_object_t& src) {
-   return {src.string, src.another_string, src.boolean, to_pb(src.nested_object)};
-}
-
-inline obj_t to_pb(const ::obj_t& src) {
-   return {to_pb(src.fixed_object), to_pb(src.fixed_name_object), to_pb(src.another_object),
-           src.string_array, src.string, src.number, src.boolean, src.another_bool};
-}
-
-// Convert from protobuf structs back to regular structs
-inline ::fixed_object_t from_pb(const fixed_object_t& src) {
-   ::fixed_object_t dst;
-   dst.int_array.reserve(src.int_array.size());
-   for (auto v : src.int_array) dst.int_array.push_back(static_cast<int>(v));
-   dst.float_array = src.float_array;
-   dst.double_array = src.double_array;
-   return dst;
-}
-
-inline ::fixed_name_object_t from_pb(const fixed_name_object_t& src) {
-   return {src.name0, src.name1, src.name2, src.name3, src.name4};
-}
-
-inline ::nested_object_t from_pb(const nested_object_t& src) {
-   ::nested_object_t dst;
-   dst.v3s.reserve(src.v3s.size());
-   for (const auto& v : src.v3s) {
-      dst.v3s.push_back({v.x, v.y, v.z});
-   }
-   dst.id = src.id;
-   return dst;
-}
-
-inline ::another_object_t from_pb(const another_object_t& src) {
-   return {src.string, src.another_string, src.boolean, from_pb(src.nested_object)};
-}
-
-inline ::obj_t from_pb(const obj_t& src) {
-   return {from_pb(src.fixed_object), from_pb(src.fixed_name_object), from_pb(src.another_object),
-           src.string_array, src.string, src.number, src.boolean, src.another_bool};
-}
-
-} // namespace pb
-
-#ifdef NDEBUG
-static constexpr size_t iterations = 1'000'000;
-#else
-static constexpr size_t iterations = 100'000;
-#endif
-
-struct results
-{
-   double write{};
-   double read{};
-   uint64_t size{};
-};
-
-// JSON tests (Glaze)
-results json_test()
-{
-   std::string buffer{json0};
-   obj_t obj{};
-   glz::ex::read_json(obj, buffer);
-
-   auto t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_json(obj, buffer);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      if (glz::read_json(obj, buffer)) {
-         std::cerr << "glaze json error!\n";
-         break;
+   std::vector<std::string> items;
+   while (!list.empty()) {
+      const auto comma = list.find(',');
+      if (const auto item = list.substr(0, comma); !item.empty()) {
+         items.emplace_back(item);
       }
+      list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, buffer.size()};
+   return items;
 }
 
-// BEVE tests
-results beve_test()
+options parse_options(int argc, char** argv)
 {
-   std::string buffer{json0};
-   obj_t obj{};
-   glz::ex::read_json(obj, buffer);
-
-   auto t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_beve(obj, buffer);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      if (glz::read_beve(obj, buffer)) {
-         std::cerr << "glaze error!\n";
-         break;
+   options opts{};
+   for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      const bool has_value = i + 1 < argc && argv[i + 1][0] != '-';
+      if (arg == "--threads") {
+         opts.threads = has_value ? std::stoul(argv[++i]) : 0;
+         if (opts.threads == 0) {
+            opts.threads = allowed_cpus().size();
+         }
+      }
+      else if (arg == "--sweep") {
+         opts.sweep = has_value ? std::stoul(argv[++i]) : 10'000'000;
+      }
+      else if (arg == "--cold") {
+         const auto llc = detect_caches().llc;
+         opts.cold = has_value ? std::stoull(argv[++i]) << 20 : (llc ? 2 * llc : uint64_t(256) << 20);
+      }
+      else if (arg == "--varied") {
+         opts.varied = has_value ? std::stoul(argv[++i]) : 64;
+      }
+      else if (arg == "--shuffle") {
+         opts.shuffle = true;
+      }
+      else if (arg == "--fields") {
+         opts.fields = has_value ? std::stoul(argv[++i]) : 100'000;
+      }
+      else if (arg == "--stream") {
+         opts.stream = has_value ? std::stoul(argv[++i]) : 1'000'000;
+      }
+      else if (arg == "--pipeline") {
+         opts.pipeline = has_value ? std::stoul(argv[++i]) : 1'000'000;
+      }
+      else if (arg == "--no-uring") {
+         opts.uring = false;
+      }
+      else if (arg == "--rpc") {
+         opts.rpc = true;
+      }
+      else if (arg == "--arena") {
+         opts.arena = true;
+      }
+      else if (arg == "--evolution") {
+         opts.evolution = true;
+      }
+      else if (arg == "--validate") {
+         opts.validate = true;
+      }
+      else if (arg == "--families") {
+         opts.families = has_value ? std::stoul(argv[++i]) : 1'000'000;
+      }
+      else if (arg == "--string-lengths") {
+         if (!has_value) {
+            std::cerr << "--string-lengths needs a comma separated list of short, log, uniform, long\n";
+            std::exit(1);
+         }
+         opts.string_lengths.clear();
+         for (const auto& item : split_list(argv[++i])) {
+            const auto l = std::find_if(all_string_lengths.begin(), all_string_lengths.end(),
+                                        [&](string_length l) { return string_length_id(l) == item; });
+            if (l == all_string_lengths.end()) {
+               std::cerr << "Unknown string length: " << item << "\n";
+               std::exit(1);
+            }
+            opts.string_lengths.push_back(*l);
+         }
+         if (opts.families == 0) {
+            opts.families = 1'000'000;
+         }
+      }
+      else if (arg == "--prefilter") {
+         opts.prefilter = true;
+      }
+      else if (arg == "--distributions") {
+         opts.distributions = true;
+      }
+      else if (arg == "--batch") {
+         opts.batch = true;
+      }
+      else if (arg == "--layout") {
+         opts.layout = has_value ? std::stoul(argv[++i]) : 10'000'000;
+      }
+      else if (arg == "--compare") {
+         if (i + 2 >= argc) {
+            std::cerr << "--compare needs a baseline and a candidate results.json\n";
+            std::exit(1);
+         }
+         opts.compare = {argv[i + 1], argv[i + 2]};
+         i += 2;
+      }
+      else if (arg == "--threshold") {
+         if (!has_value) {
+            std::cerr << "--threshold needs a percentage\n";
+            std::exit(1);
+         }
+         opts.threshold = std::stod(argv[++i]);
+      }
+      else if (arg == "--matrix") {
+         opts.matrix = true;
+      }
+      else if (arg == "--codec" || arg == "--payload" || arg == "--size") {
+         if (!has_value) {
+            std::cerr << arg << " needs a comma separated list, see --list\n";
+            std::exit(1);
+         }
+         auto items = split_list(argv[++i]);
+         if (arg == "--codec") {
+            opts.filter.codecs = std::move(items);
+         }
+         else if (arg == "--payload") {
+            opts.filter.payloads = std::move(items);
+         }
+         else {
+            for (const auto& item : items) {
+               opts.filter.sizes.push_back(std::stoul(item));
+            }
+         }
+         opts.matrix = true;
+      }
+      else if (arg == "--list") {
+         opts.list = true;
+      }
+      else if (arg == "--seconds") {
+         if (!has_value) {
+            std::cerr << "--seconds needs a duration per timed phase\n";
+            std::exit(1);
+         }
+         measure_defaults.target_seconds = std::stod(argv[++i]);
+      }
+      else if (arg == "--no-counters") {
+         measure_defaults.counters = false;
+      }
+      else {
+         std::cerr << "Unknown option: " << arg << "\n";
+         std::exit(1);
       }
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, buffer.size()};
+   return opts;
 }
 
-// MessagePack tests
-results msgpack_test()
-{
-   obj_t obj{};
-   std::string buffer{json0};
-   glz::ex::read_json(obj, buffer);
-
-   auto t0 = std::chrono::steady_clock::now();
-   msgpack::sbuffer packed{};
-   for (size_t i = 0; i < iterations; ++i) {
-      packed.clear();
-      msgpack::pack(packed, obj);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   obj = obj_t{};
-   t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      msgpack::object_handle oh = msgpack::unpack(packed.data(), packed.size());
-      oh.get().convert(obj);
-   }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
+} // namespace
 
-   return {write, read, packed.size()};
-}
-
-// CBOR tests (Glaze)
-results cbor_test()
+int main(int argc, char** argv)
 {
-   obj_t obj{};
-   std::string buffer{json0};
-   glz::ex::read_json(obj, buffer);
-
-   auto t0 = std::chrono::steady_clock::now();
-   std::string packed;
-   for (size_t i = 0; i < iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_cbor(obj, packed);
+   const auto opts = parse_options(argc, argv);
+   if (!opts.compare.empty()) {
+      return compare_runs(opts.compare[0], opts.compare[1], opts.threshold);
    }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   obj = obj_t{};
-   t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      if (glz::read_cbor(obj, packed)) {
-         std::cerr << "glaze cbor error!\n";
-         break;
-      }
+   if (opts.list) {
+      list_matrix();
+      return 0;
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   return {write, read, packed.size()};
-}
+   report rep{};
 
-// Protobuf tests (zpp_bits in protobuf mode)
-results protobuf_test()
-{
-   obj_t obj{};
-   std::string buffer{json0};
-   glz::ex::read_json(obj, buffer);
-
-   // Include conversion in the benchmark for fair comparison
-   auto t0 = std::chrono::steady_clock::now();
-   std::vector<std::byte> packed;
-   for (size_t i = 0; i < iterations; ++i) {
-      packed.clear();
-      auto pb_obj = pb::to_pb(obj);  // Conversion inside loop
-      auto out = zpp::bits::out(packed, zpp::bits::no_size{});
-      [[maybe_unused]] auto result = out(pb_obj);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   // Include conversion in the benchmark for fair comparison
-   t0 = std::chrono::steady_clock::now();
-   for (size_t i = 0; i < iterations; ++i) {
-      pb::obj_t pb_obj{};
-      auto in = zpp::bits::in(packed, zpp::bits::no_size{});
-      [[maybe_unused]] auto result = in(pb_obj);
-      [[maybe_unused]] auto native_obj = pb::from_pb(pb_obj);  // Conversion inside loop
+   std::cout << "Running benchmarks...\n";
+   if (measure_defaults.counters && !perf_counters_available()) {
+      std::cout << "Hardware performance counters unavailable, reporting timing only\n";
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, packed.size()};
-}
-
-constexpr auto vector_size = 10'000;
-constexpr auto vector_iterations = iterations / 10;
+   std::cout << "\n";
 
-template <class T>
-results json_vector_test()
-{
-   std::mt19937_64 gen{};
-   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
-                                     std::uniform_int_distribution<T>>;
-   dist_t dist{0, (std::numeric_limits<T>::max)()};
-   std::vector<T> x(vector_size);
-   for (auto& v : x) {
-      v = dist(gen);
+   if (opts.matrix) {
+      std::cout << "Testing: codec matrix\n";
+      rep.matrix = matrix_test(opts.filter);
+      if (rep.matrix.empty()) {
+         std::cerr << "No matrix cell matches the selection, see --list\n";
+         return 1;
+      }
    }
-
-   auto t0 = std::chrono::steady_clock::now();
-   std::string packed{};
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_json(x, packed);
+   else {
+      fixed_tests(rep);
    }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   t0 = std::chrono::steady_clock::now();
-   std::vector<T> y;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      glz::ex::read_json(y, packed);
+   if (opts.families) {
+      for (auto& r : family_test(opts.families, opts.string_lengths)) {
+         rep.results.push_back(std::move(r));
+      }
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, packed.size()};
-}
 
-template <class T>
-results beve_vector_test()
-{
-   std::mt19937_64 gen{};
-   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
-                                     std::uniform_int_distribution<T>>;
-   dist_t dist{0, (std::numeric_limits<T>::max)()};
-   std::vector<T> x(vector_size);
-   for (auto& v : x) {
-      v = dist(gen);
+   if (opts.fields) {
+      std::cout << "Testing: selective field access (arrays up to " << opts.fields << " elements)\n";
+      rep.fields = field_access_test(opts.fields);
    }
 
-   auto t0 = std::chrono::steady_clock::now();
-   std::string packed{};
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_beve(x, packed);
+   if (opts.stream) {
+      std::cout << "Testing: streaming file I/O (" << opts.stream << " records)\n";
+      rep.stream = stream_test(opts.stream);
    }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   t0 = std::chrono::steady_clock::now();
-   std::vector<T> y;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      glz::ex::read_beve(y, packed);
+   if (opts.pipeline) {
+      std::cout << "Testing: pipelined serialize, write, read, deserialize (" << opts.pipeline << " records)\n";
+      rep.pipeline = pipeline_test(opts.pipeline, opts.uring);
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, packed.size()};
-}
 
-template <class T>
-results msgpack_vector_test()
-{
-   std::mt19937_64 gen{};
-   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
-                                     std::uniform_int_distribution<T>>;
-   dist_t dist{0, (std::numeric_limits<T>::max)()};
-   std::vector<T> x(vector_size);
-   for (auto& v : x) {
-      v = dist(gen);
+   if (opts.rpc) {
+      std::cout << "Testing: loopback RPC round trips\n";
+      rep.rpc = rpc_test();
    }
 
-   auto t0 = std::chrono::steady_clock::now();
-   msgpack::sbuffer packed{};
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      packed.clear();
-      msgpack::pack(packed, x);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   t0 = std::chrono::steady_clock::now();
-   std::vector<T> y;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      msgpack::object_handle oh = msgpack::unpack(packed.data(), packed.size());
-      oh.get().convert(y);
+   if (opts.arena) {
+      std::cout << "Testing: arena-backed reads and fixed-buffer writes\n";
+      rep.arena = arena_test();
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   return {write, read, packed.size()};
-}
-
-template <class T>
-results cbor_vector_test()
-{
-   std::mt19937_64 gen{};
-   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
-                                     std::uniform_int_distribution<T>>;
-   dist_t dist{0, (std::numeric_limits<T>::max)()};
-   std::vector<T> x(vector_size);
-   for (auto& v : x) {
-      v = dist(gen);
+   if (opts.evolution) {
+      std::cout << "Testing: schema evolution\n";
+      rep.evolution = evolution_test();
    }
 
-   auto t0 = std::chrono::steady_clock::now();
-   std::string packed;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      [[maybe_unused]] auto ec = glz::write_cbor(x, packed);
+   if (opts.validate) {
+      std::cout << "Testing: validate-only parsing\n";
+      rep.validation = validation_test();
    }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   t0 = std::chrono::steady_clock::now();
-   std::vector<T> y;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      if (glz::read_cbor(y, packed)) {
-         std::cerr << "glaze cbor vector error!\n";
-         break;
-      }
+   if (opts.prefilter) {
+      std::cout << "Testing: numeric array pre-filters\n";
+      rep.prefilter = prefilter_test();
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   return {write, read, packed.size()};
-}
-
-// Protobuf vector wrapper for proper encoding
-template <typename T>
-struct pb_vector_wrapper {
-   std::vector<T> data;
-   using serialize = zpp::bits::pb_protocol;
-};
 
-template <class T>
-results protobuf_vector_test()
-{
-   std::mt19937_64 gen{};
-   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
-                                     std::uniform_int_distribution<T>>;
-   dist_t dist{0, (std::numeric_limits<T>::max)()};
-   std::vector<T> x(vector_size);
-   for (auto& v : x) {
-      v = dist(gen);
-   }
-
-   pb_vector_wrapper<T> wrapper{x};
-
-   auto t0 = std::chrono::steady_clock::now();
-   std::vector<std::byte> packed;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      packed.clear();
-      auto out = zpp::bits::out(packed, zpp::bits::no_size{});
-      [[maybe_unused]] auto result = out(wrapper);
-   }
-   auto t1 = std::chrono::steady_clock::now();
-   const auto write = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
-
-   t0 = std::chrono::steady_clock::now();
-   pb_vector_wrapper<T> y;
-   for (size_t i = 0; i < vector_iterations; ++i) {
-      auto in = zpp::bits::in(packed, zpp::bits::no_size{});
-      [[maybe_unused]] auto result = in(y);
+   if (opts.batch) {
+      std::cout << "Testing: batches of complex objects\n";
+      rep.batches = batch_test();
    }
-   t1 = std::chrono::steady_clock::now();
-   const auto read = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() * 1e-6;
 
-   return {write, read, packed.size()};
-}
-
-struct benchmark_result
-{
-   std::string name;
-   results json;
-   results beve;
-   results msgpack;
-   results cbor;
-   results protobuf;
-   size_t iterations;
-};
-
-std::string format_time(double seconds)
-{
-   std::ostringstream oss;
-   if (seconds < 0.001) {
-      oss << std::fixed << std::setprecision(2) << (seconds * 1e6) << " µs";
+   if (opts.layout) {
+      std::cout << "Testing: point cloud layouts (up to " << opts.layout << " points)\n";
+      rep.layouts = layout_test(opts.layout);
    }
-   else if (seconds < 1.0) {
-      oss << std::fixed << std::setprecision(2) << (seconds * 1e3) << " ms";
-   }
-   else {
-      oss << std::fixed << std::setprecision(3) << seconds << " s";
-   }
-   return oss.str();
-}
 
-std::string format_size(uint64_t bytes)
-{
-   std::ostringstream oss;
-   if (bytes < 1024) {
-      oss << bytes << " B";
-   }
-   else if (bytes < 1024 * 1024) {
-      oss << std::fixed << std::setprecision(2) << (bytes / 1024.0) << " KB";
+   if (opts.distributions) {
+      std::cout << "Testing: value distributions\n";
+      rep.distributions = distribution_test();
    }
-   else {
-      oss << std::fixed << std::setprecision(2) << (bytes / (1024.0 * 1024.0)) << " MB";
-   }
-   return oss.str();
-}
-
-std::string format_speedup(double baseline, double compared)
-{
-   std::ostringstream oss;
-   double speedup = baseline / compared;
-   oss << std::fixed << std::setprecision(1) << speedup << "x";
-   return oss.str();
-}
 
-std::string format_throughput(uint64_t size, double seconds, size_t iters)
-{
-   std::ostringstream oss;
-   double bytes_per_sec = (size * iters) / seconds;
-   if (bytes_per_sec >= 1e9) {
-      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e9) << " GB/s";
-   }
-   else if (bytes_per_sec >= 1e6) {
-      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e6) << " MB/s";
+   if (opts.threads) {
+      std::cout << "Testing: multi-threaded scaling (up to " << opts.threads << " threads)\n";
+      rep.scaling = scaling_test(opts.threads);
    }
-   else {
-      oss << std::fixed << std::setprecision(2) << (bytes_per_sec / 1e3) << " KB/s";
-   }
-   return oss.str();
-}
 
-void generate_markdown(const std::vector<benchmark_result>& results, const std::string& filename)
-{
-   std::ofstream out(filename);
-
-   auto now = std::chrono::system_clock::now();
-   auto time = std::chrono::system_clock::to_time_t(now);
-   std::tm tm = *std::localtime(&time);
-   std::ostringstream date_stream;
-   date_stream << std::put_time(&tm, "%B %Y");
-
-   out << "# Serialization Performance: JSON vs BEVE vs MessagePack vs CBOR vs Protobuf\n\n";
-
-   out << "Benchmark comparing [JSON](https://www.json.org/), [BEVE](https://github.com/beve-org/beve), and ";
-   out << "[CBOR](https://cbor.io/) (via [Glaze](https://github.com/stephenberry/glaze)), ";
-   out << "[MessagePack](https://github.com/msgpack/msgpack-c), and ";
-   out << "[Protocol Buffers](https://protobuf.dev/) (via [zpp_bits](https://github.com/eyalz800/zpp_bits)).\n\n";
-
-   out << "## Test Environment\n\n";
-   out << "| Property | Value |\n";
-   out << "|----------|-------|\n";
-   out << "| Date | " << date_stream.str() << " |\n";
-   out << "| Glaze | " << int(glz::version.major) << "." << int(glz::version.minor) << "." << int(glz::version.patch) << " |\n";
-   out << "| msgpack-c | 7.0.0 |\n";
-   out << "| zpp_bits (protobuf) | latest |\n";
-   out << "| C++ Standard | C++20 |\n";
-   out << "| Build | Release (-O3) |\n\n";
-
-   out << "## Speedup vs BEVE (Baseline)\n\n";
-   out << "Higher means BEVE is faster by that factor. Format: Write/Read\n\n";
-   out << "| Test | JSON | MsgPack | CBOR | Protobuf |\n";
-   out << "|------|------|---------|------|----------|\n";
-   for (const auto& r : results) {
-      out << "| " << r.name << " | ";
-      out << format_speedup(r.json.write, r.beve.write) << "/" << format_speedup(r.json.read, r.beve.read) << " | ";
-      out << format_speedup(r.msgpack.write, r.beve.write) << "/" << format_speedup(r.msgpack.read, r.beve.read) << " | ";
-      out << format_speedup(r.cbor.write, r.beve.write) << "/" << format_speedup(r.cbor.read, r.beve.read) << " | ";
-      out << format_speedup(r.protobuf.write, r.beve.write) << "/" << format_speedup(r.protobuf.read, r.beve.read) << " |\n";
+   if (opts.sweep) {
+      std::cout << "Testing: payload size sweep (16 to " << opts.sweep << " elements)\n";
+      rep.sweep = sweep_test(opts.sweep);
    }
 
-   out << "\n## Message Sizes\n\n";
-   out << "| Test | JSON | BEVE | MessagePack | CBOR | Protobuf |\n";
-   out << "|------|------|------|-------------|------|----------|\n";
-   for (const auto& r : results) {
-      out << "| " << r.name << " | ";
-      out << format_size(r.json.size) << " | ";
-      out << format_size(r.beve.size) << " | ";
-      out << format_size(r.msgpack.size) << " | ";
-      out << format_size(r.cbor.size) << " | ";
-      out << format_size(r.protobuf.size) << " |\n";
+   if (opts.cold) {
+      std::cout << "Testing: cache-cold buffer pool (" << format_size(opts.cold) << " per format)\n";
+      rep.cold_pool_bytes = opts.cold;
+      rep.cold_shuffled = opts.shuffle;
+      rep.cold = cold_test(opts.cold, opts.shuffle);
    }
 
-   out << "\n## Detailed Results\n";
-
-   for (const auto& r : results) {
-      out << "\n### " << r.name << "\n\n";
-      out << "**Iterations:** " << r.iterations << "\n\n";
-
-      out << "| Metric | JSON | BEVE | MessagePack | CBOR | Protobuf |\n";
-      out << "|--------|------|------|-------------|------|----------|\n";
-
-      out << "| Message Size | " << format_size(r.json.size) << " | ";
-      out << format_size(r.beve.size) << " | ";
-      out << format_size(r.msgpack.size) << " | ";
-      out << format_size(r.cbor.size) << " | ";
-      out << format_size(r.protobuf.size) << " |\n";
-
-      out << "| Write Throughput | " << format_throughput(r.json.size, r.json.write, r.iterations) << " | ";
-      out << format_throughput(r.beve.size, r.beve.write, r.iterations) << " | ";
-      out << format_throughput(r.msgpack.size, r.msgpack.write, r.iterations) << " | ";
-      out << format_throughput(r.cbor.size, r.cbor.write, r.iterations) << " | ";
-      out << format_throughput(r.protobuf.size, r.protobuf.write, r.iterations) << " |\n";
-
-      out << "| Read Throughput | " << format_throughput(r.json.size, r.json.read, r.iterations) << " | ";
-      out << format_throughput(r.beve.size, r.beve.read, r.iterations) << " | ";
-      out << format_throughput(r.msgpack.size, r.msgpack.read, r.iterations) << " | ";
-      out << format_throughput(r.cbor.size, r.cbor.read, r.iterations) << " | ";
-      out << format_throughput(r.protobuf.size, r.protobuf.read, r.iterations) << " |\n";
+   if (opts.varied) {
+      std::cout << "Testing: varied payloads (" << opts.varied << " distinct messages)\n";
+      rep.varied_payloads = opts.varied;
+      rep.varied = varied_test(opts.varied);
    }
 
-   out << "\n## Analysis\n\n";
-
-   out << "### Why BEVE and CBOR (Glaze) Excel at Numeric Arrays\n\n";
-   out << "Both BEVE and CBOR (via Glaze) store contiguous arrays of trivially copyable types as raw memory blocks, ";
-   out << "enabling efficient `memcpy` operations. MessagePack encodes each element individually ";
-   out << "with type tags, resulting in significant overhead for numeric data. ";
-   out << "Protobuf (via zpp_bits) also uses memcpy for packed repeated fields, but has additional overhead from ";
-   out << "varint length prefixes, field tags, and in this benchmark, struct conversion between native C++ types and protobuf-compatible types.\n";
-
-   out.close();
-
-   std::cout << "Benchmark results written to: " << filename << "\n";
-}
-
-int main()
-{
-   std::vector<benchmark_result> all_results;
-
-   std::cout << "Running benchmarks...\n\n";
-
-   // Complex object test
-   std::cout << "Testing: Complex Nested Object\n";
-   auto json_obj = json_test();
-   auto beve_obj = beve_test();
-   auto msgpack_obj = msgpack_test();
-   auto cbor_obj = cbor_test();
-   auto protobuf_obj = protobuf_test();
-   all_results.push_back({"Complex Nested Object", json_obj, beve_obj, msgpack_obj, cbor_obj, protobuf_obj, iterations});
-
-   // Vector tests
-   std::cout << "Testing: std::vector<double> (10,000 elements)\n";
-   auto json_double = json_vector_test<double>();
-   auto beve_double = beve_vector_test<double>();
-   auto msgpack_double = msgpack_vector_test<double>();
-   auto cbor_double = cbor_vector_test<double>();
-   auto protobuf_double = protobuf_vector_test<double>();
-   all_results.push_back({"std::vector<double> (10K)", json_double, beve_double, msgpack_double, cbor_double, protobuf_double, vector_iterations});
-
-   std::cout << "Testing: std::vector<float> (10,000 elements)\n";
-   auto json_float = json_vector_test<float>();
-   auto beve_float = beve_vector_test<float>();
-   auto msgpack_float = msgpack_vector_test<float>();
-   auto cbor_float = cbor_vector_test<float>();
-   auto protobuf_float = protobuf_vector_test<float>();
-   all_results.push_back({"std::vector<float> (10K)", json_float, beve_float, msgpack_float, cbor_float, protobuf_float, vector_iterations});
-
-   std::cout << "Testing: std::vector<uint64_t> (10,000 elements)\n";
-   auto json_u64 = json_vector_test<uint64_t>();
-   auto beve_u64 = beve_vector_test<uint64_t>();
-   auto msgpack_u64 = msgpack_vector_test<uint64_t>();
-   auto cbor_u64 = cbor_vector_test<uint64_t>();
-   auto protobuf_u64 = protobuf_vector_test<uint64_t>();
-   all_results.push_back({"std::vector<uint64_t> (10K)", json_u64, beve_u64, msgpack_u64, cbor_u64, protobuf_u64, vector_iterations});
-
-   std::cout << "Testing: std::vector<uint32_t> (10,000 elements)\n";
-   auto json_u32 = json_vector_test<uint32_t>();
-   auto beve_u32 = beve_vector_test<uint32_t>();
-   auto msgpack_u32 = msgpack_vector_test<uint32_t>();
-   auto cbor_u32 = cbor_vector_test<uint32_t>();
-   auto protobuf_u32 = protobuf_vector_test<uint32_t>();
-   all_results.push_back({"std::vector<uint32_t> (10K)", json_u32, beve_u32, msgpack_u32, cbor_u32, protobuf_u32, vector_iterations});
-
-   std::cout << "Testing: std::vector<uint16_t> (10,000 elements)\n";
-   auto json_u16 = json_vector_test<uint16_t>();
-   auto beve_u16 = beve_vector_test<uint16_t>();
-   auto msgpack_u16 = msgpack_vector_test<uint16_t>();
-   auto cbor_u16 = cbor_vector_test<uint16_t>();
-   auto protobuf_u16 = protobuf_vector_test<uint16_t>();
-   all_results.push_back({"std::vector<uint16_t> (10K)", json_u16, beve_u16, msgpack_u16, cbor_u16, protobuf_u16, vector_iterations});
-
    std::cout << "\n";
 
    // Generate markdown report
-   generate_markdown(all_results, "results.md");
+   generate_markdown(rep, "results.md");
+   write_results_json(rep, "results.json");
+   if (!rep.sweep.empty()) {
+      write_sweep_csv(rep, "sweep.csv");
+   }
 
    // Print summary to console
-   std::cout << "\n=== Summary (BEVE speedup vs others, Write/Read) ===\n\n";
-   std::cout << std::left << std::setw(30) << "Test"
-             << std::setw(14) << "JSON"
-             << std::setw(14) << "MsgPack"
-             << std::setw(14) << "CBOR"
-             << std::setw(14) << "Protobuf" << "\n";
-   std::cout << std::string(86, '-') << "\n";
-
-   for (const auto& r : all_results) {
-      std::cout << std::left << std::setw(30) << r.name
-                << std::setw(14) << (format_speedup(r.json.write, r.beve.write) + "/" + format_speedup(r.json.read, r.beve.read))
-                << std::setw(14) << (format_speedup(r.msgpack.write, r.beve.write) + "/" + format_speedup(r.msgpack.read, r.beve.read))
-                << std::setw(14) << (format_speedup(r.cbor.write, r.beve.write) + "/" + format_speedup(r.cbor.read, r.beve.read))
-                << std::setw(14) << (format_speedup(r.protobuf.write, r.beve.write) + "/" + format_speedup(r.protobuf.read, r.beve.read)) << "\n";
+   if (!rep.results.empty()) {
+      constexpr auto baseline = format_index<beve_codec>;
+      std::cout << "\n=== Summary (BEVE speedup vs others, Write/Read) ===\n\n";
+      std::cout << std::left << std::setw(30) << "Test";
+      for (size_t f = 0; f < format_count; ++f) {
+         if (f != baseline) {
+            std::cout << std::setw(14) << format_names[f];
+         }
+      }
+      std::cout << "\n" << std::string(30 + 14 * (format_count - 1), '-') << "\n";
+
+      for (const auto& r : rep.results) {
+         const auto& base = r.formats[baseline];
+         std::cout << std::left << std::setw(30) << r.name;
+         for (size_t f = 0; f < format_count; ++f) {
+            if (f != baseline) {
+               const auto& other = r.formats[f];
+               std::cout << std::setw(14)
+                         << (format_speedup(other.write, base.write) + "/" + format_speedup(other.read, base.read));
+            }
+         }
+         std::cout << "\n";
+      }
    }
 
    return 0;
@@ -0,0 +1,146 @@
+// Codec matrix: every registered codec on every registered payload it supports, at each of the payload's sizes. A
+// payload generates values of one type at a given size (element, object or point count); adding a codec to
+// all_codecs or a payload to matrix_payloads() adds its row or column.
+
+#include <functional>
+#include <iostream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+template <class T>
+struct payload
+{
+   std::string_view id;
+   std::string_view name;
+   std::vector<size_t> sizes;
+   T (*make)(size_t);
+};
+
+template <class T>
+payload<std::vector<T>> vector_payload(std::string_view id, std::string_view name)
+{
+   return {id, name, {16, 10'000, 1'000'000}, [](size_t n) { return random_vector<T>(n); }};
+}
+
+auto matrix_payloads()
+{
+   return std::tuple{
+      payload<obj_t>{"object", "Complex Nested Object", {1, 100, 10'000}, scaled_obj},
+      vector_payload<double>("f64", "std::vector<double>"),
+      vector_payload<float>("f32", "std::vector<float>"),
+      vector_payload<uint64_t>("u64", "std::vector<uint64_t>"),
+      vector_payload<uint32_t>("u32", "std::vector<uint32_t>"),
+      vector_payload<uint16_t>("u16", "std::vector<uint16_t>"),
+      vector_payload<int64_t>("i64", "std::vector<int64_t>"),
+      vector_payload<int32_t>("i32", "std::vector<int32_t>"),
+      payload<std::vector<obj_t>>{"batch", "std::vector<obj_t>", {1, 256, 4096}, random_objs},
+      payload<points_aos_t>{"points-aos", "Point cloud (AoS)", {10, 10'000, 1'000'000}, random_points},
+      payload<points_soa_t>{"points-soa", "Point cloud (SoA)", {10, 10'000, 1'000'000},
+                            [](size_t n) { return to_soa(random_points(n)); }},
+   };
+}
+
+// One cell, run on demand so that listing and filtering the matrix costs nothing
+struct matrix_entry
+{
+   std::string codec;
+   std::string payload;
+   size_t size{};
+   std::string codec_name;
+   std::string payload_name;
+   std::function<results()> run;
+};
+
+template <class Codec, class T>
+void add_matrix_entry(std::vector<matrix_entry>& entries, const payload<T>& p, size_t size)
+{
+   if constexpr (codec<Codec, T>) {
+      if (codec_enabled<Codec>()) {
+         entries.push_back({std::string(Codec::id), std::string(p.id), size, std::string(Codec::name),
+                            std::string(p.name),
+                            [make = p.make, size] { return run_codec<Codec>(make(size)); }});
+      }
+   }
+}
+
+template <class T, class... Codecs>
+void add_matrix_entries(std::vector<matrix_entry>& entries, const payload<T>& p, const matrix_filter& filter,
+                        std::tuple<Codecs...>)
+{
+   for (const auto size : filter.sizes.empty() ? p.sizes : filter.sizes) {
+      (add_matrix_entry<Codecs>(entries, p, size), ...);
+   }
+}
+
+// Ordered by payload, then size, then codec
+std::vector<matrix_entry> matrix_entries(const matrix_filter& filter)
+{
+   std::vector<matrix_entry> entries;
+   std::apply([&](const auto&... p) { (add_matrix_entries(entries, p, filter, all_codecs{}), ...); },
+              matrix_payloads());
+   std::erase_if(entries, [&](const matrix_entry& e) { return !filter.selects(e.codec, e.payload); });
+   return entries;
+}
+
+} // namespace
+
+std::vector<matrix_cell> matrix_test(const matrix_filter& filter)
+{
+   std::vector<matrix_cell> cells;
+   for (const auto& e : matrix_entries(filter)) {
+      std::cout << "  " << e.payload_name << " (" << e.size << "), " << e.codec_name << "\n";
+      cells.push_back({e.codec_name, e.payload_name, e.size, e.run()});
+   }
+   return cells;
+}
+
+void list_matrix()
+{
+   const auto print_codec = [](auto c) {
+      using C = decltype(c);
+      if (codec_enabled<C>()) {
+         std::cout << " " << C::id;
+      }
+   };
+   const auto print_payload = [](const auto& p) {
+      std::cout << "  " << p.id << " (" << p.name << "):";
+      for (const auto size : p.sizes) {
+         std::cout << " " << size;
+      }
+      std::cout << "\n";
+   };
+   std::cout << "Codecs:";
+   std::apply([&](auto... c) { (print_codec(c), ...); }, all_codecs{});
+   std::cout << "\nPayloads:\n";
+   std::apply([&](const auto&... p) { (print_payload(p), ...); }, matrix_payloads());
+}
+
+// One table per payload and size, with a row per codec
+void write_matrix_section(std::ostream& out, const report& rep)
+{
+   const auto& cells = rep.matrix;
+   if (cells.empty()) {
+      return;
+   }
+
+   out << "\n## Codec Matrix\n\n";
+   out << "Every selected codec on every selected payload it supports. Each phase is timed for "
+       << measure_defaults.target_seconds << " s; Fresh Read decodes into a default constructed value every time.\n";
+   for (size_t i = 0; i < cells.size(); ++i) {
+      const auto& c = cells[i];
+      if (i == 0 || c.payload != cells[i - 1].payload || c.size != cells[i - 1].size) {
+         out << "\n### " << c.payload << " (" << c.size << ")\n\n";
+         out << "| Codec | Message Size | Write | Read | Fresh Read | Read Allocations |\n";
+         out << "|-------|--------------|-------|------|------------|------------------|\n";
+      }
+      const auto& r = c.result;
+      out << "| " << c.codec << " | " << format_size(r.size) << " | " << format_throughput(r.size, r.write) << " | "
+          << format_throughput(r.size, r.read) << " | " << format_throughput(r.size, r.read_fresh) << " | "
+          << format_allocs(r.read) << " |\n";
+   }
+}
@@ -0,0 +1,149 @@
+#include "payloads.hpp"
+
+#include <array>
+#include <cmath>
+#include <string>
+
+#include "glaze/glaze.hpp"
+#include "glaze/glaze_exceptions.hpp"
+
+static constexpr std::string_view json0 = R"(
+{
+   "fixed_object": {
+      "int_array": [0, 1, 2, 3, 4, 5, 6],
+      "float_array": [0.1, 0.2, 0.3, 0.4, 0.5, 0.6],
+      "double_array": [3288398.238, 233e22, 289e-1, 0.928759872, 0.22222848, 0.1, 0.2, 0.3, 0.4]
+   },
+   "fixed_name_object": {
+      "name0": "James",
+      "name1": "Abraham",
+      "name2": "Susan",
+      "name3": "Frank",
+      "name4": "Alicia"
+   },
+   "another_object": {
+      "string": "here is some text",
+      "another_string": "Hello World",
+      "boolean": false,
+      "nested_object": {
+         "v3s": [[0.12345, 0.23456, 0.001345],
+                  [0.3894675, 97.39827, 297.92387],
+                  [18.18, 87.289, 2988.298]],
+         "id": "298728949872"
+      }
+   },
+   "string_array": ["Cat", "Dog", "Elephant", "Tiger"],
+   "string": "Hello world",
+   "number": 3.14,
+   "boolean": true,
+   "another_bool": false
+}
+)";
+
+obj_t make_obj()
+{
+   obj_t obj{};
+   glz::ex::read_json(obj, json0);
+   return obj;
+}
+
+obj_t random_obj(std::mt19937_64& gen)
+{
+   const auto length = [&](size_t lo, size_t hi) { return std::uniform_int_distribution<size_t>{lo, hi}(gen); };
+   const auto flag = [&] { return bool(gen() & 1); };
+   const auto text = [&](size_t lo, size_t hi) {
+      std::string s(length(lo, hi), ' ');
+      for (auto& c : s) {
+         c = char(std::uniform_int_distribution<int>{'a', 'z'}(gen));
+      }
+      return s;
+   };
+   const auto integer = [&] { // uniform bit length, so varints and JSON numbers vary in width
+      const auto v = int(gen() & ((uint64_t(1) << length(0, 31)) - 1));
+      return flag() ? -v : v;
+   };
+   const auto real = [&] { // log-uniform magnitude over 1e-6 .. 1e12
+      const auto v = std::pow(10.0, std::uniform_real_distribution<double>{-6.0, 12.0}(gen));
+      return flag() ? -v : v;
+   };
+   const auto fill = [](auto& v, size_t n, auto&& make) {
+      v.resize(n);
+      for (auto& e : v) {
+         e = make();
+      }
+   };
+
+   obj_t obj{};
+   fill(obj.fixed_object.int_array, length(1, 16), integer);
+   fill(obj.fixed_object.float_array, length(1, 16), [&] { return float(real()); });
+   fill(obj.fixed_object.double_array, length(1, 16), real);
+   for (auto* name : {&obj.fixed_name_object.name0, &obj.fixed_name_object.name1, &obj.fixed_name_object.name2,
+                      &obj.fixed_name_object.name3, &obj.fixed_name_object.name4}) {
+      *name = text(0, 24);
+   }
+   auto& another = obj.another_object;
+   another.string = text(0, 48);
+   another.another_string = text(0, 48);
+   another.boolean = flag();
+   fill(another.nested_object.v3s, length(0, 8), [&] { return std::array<double, 3>{real(), real(), real()}; });
+   another.nested_object.id = std::to_string(gen() >> length(0, 63));
+   fill(obj.string_array, length(0, 8), [&] { return text(1, 16); });
+   obj.string = text(0, 32);
+   obj.number = real();
+   obj.boolean = flag();
+   obj.another_bool = flag();
+   return obj;
+}
+
+std::vector<obj_t> random_objs(size_t n)
+{
+   std::mt19937_64 gen{};
+   std::vector<obj_t> objs(n);
+   for (auto& obj : objs) {
+      obj = random_obj(gen);
+   }
+   return objs;
+}
+
+obj_t scaled_obj(size_t elements)
+{
+   auto obj = make_obj();
+   const auto grow = [&](auto& v) {
+      const auto n = v.size();
+      for (size_t i = n; i < elements; ++i) {
+         v.push_back(v[i % n]);
+      }
+   };
+   grow(obj.fixed_object.int_array);
+   grow(obj.fixed_object.float_array);
+   grow(obj.fixed_object.double_array);
+   grow(obj.another_object.nested_object.v3s);
+   grow(obj.string_array);
+   return obj;
+}
+
+points_aos_t random_points(size_t n)
+{
+   std::mt19937_64 gen{};
+   std::uniform_real_distribution<double> coordinate{-100.0, 100.0};
+   points_aos_t aos{};
+   aos.points.resize(n);
+   for (auto& p : aos.points) {
+      p = {coordinate(gen), coordinate(gen), coordinate(gen)};
+   }
+   return aos;
+}
+
+points_soa_t to_soa(const points_aos_t& aos)
+{
+   points_soa_t soa{};
+   for (auto* axis : {&soa.x, &soa.y, &soa.z}) {
+      axis->reserve(aos.points.size());
+   }
+   for (const auto& p : aos.points) {
+      soa.x.push_back(p[0]);
+      soa.y.push_back(p[1]);
+      soa.z.push_back(p[2]);
+   }
+   return soa;
+}
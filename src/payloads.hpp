@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "types.hpp"
+
+// Payload generators shared by the modes. Every generator is deterministic, so repeated runs measure the same bytes.
+
+// Element count of the vector payloads
+constexpr size_t vector_size = 10'000;
+
+// The json0 payload as a native object
+obj_t make_obj();
+
+// A schema-identical variation of json0: string lengths, array lengths, numeric magnitudes and booleans are drawn
+// independently, so consecutive messages take different paths through data-dependent branches
+obj_t random_obj(std::mt19937_64& gen);
+
+std::vector<obj_t> random_objs(size_t n);
+
+// The json0 object with every array grown to at least `elements` entries by repeating its contents, so the routed
+// fields sit behind a payload of increasing size
+obj_t scaled_obj(size_t elements);
+
+points_aos_t random_points(size_t n);
+
+points_soa_t to_soa(const points_aos_t& aos);
+
+template <class T>
+std::vector<T> random_vector(size_t n = vector_size, uint64_t seed = std::mt19937_64::default_seed)
+{
+   std::mt19937_64 gen{seed};
+   using dist_t = std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
+                                     std::uniform_int_distribution<T>>;
+   // Floating point from 0, integers over their whole range (negative values included for signed types)
+   dist_t dist{std::is_floating_point_v<T> ? T(0) : (std::numeric_limits<T>::min)(), (std::numeric_limits<T>::max)()};
+   std::vector<T> x(n);
+   for (auto& v : x) {
+      v = dist(gen);
+   }
+   return x;
+}
+
+// f(std::type_identity<T>{}, name) for each element type of the vector payloads in the fixed, scaling, sweep, cold,
+// varied and validation modes
+template <class F>
+void for_each_vector_type(F&& f)
+{
+   f(std::type_identity<double>{}, std::string_view{"double"});
+   f(std::type_identity<float>{}, std::string_view{"float"});
+   f(std::type_identity<uint64_t>{}, std::string_view{"uint64_t"});
+   f(std::type_identity<uint32_t>{}, std::string_view{"uint32_t"});
+   f(std::type_identity<uint16_t>{}, std::string_view{"uint16_t"});
+}
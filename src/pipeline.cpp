@@ -0,0 +1,304 @@
+// Pipeline mode: a serializer thread encodes objects into a ring of chunk buffers, an I/O thread writes every full
+// chunk to a file and, as soon as the write completes, reads it back into a second ring, and a deserializer thread
+// decodes the records from there, so the four stages overlap. Records use the record_log framing and never straddle
+// chunks. As in the streaming test nothing is fsync'ed, so reads are served from the page cache.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "async_io.hpp"
+#include "record_log.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr size_t pipeline_chunk_size = size_t(1) << 20;
+constexpr uint32_t pipeline_slots = 8; // chunk buffers per ring
+constexpr size_t pipeline_passes = 3;
+
+constexpr std::array<std::string_view, 4> pipeline_stages{"serialize", "write", "read", "deserialize"};
+
+// Records in one buffer of either ring, at their position in the file
+struct pipeline_chunk
+{
+   uint32_t slot{};
+   uint32_t length{};
+   uint64_t offset{};
+   size_t records{};
+};
+
+// Work for the I/O thread
+struct pipeline_event
+{
+   enum kind_t : uint8_t { filled, read_slot_free, finished } kind{};
+   pipeline_chunk chunk{};
+};
+
+// slots holds the write ring followed by the read ring, and engine was created on them
+template <class Codec, class Engine>
+pipeline_result run_pipeline_stages(Engine& engine, std::vector<std::vector<char>>& slots, size_t records)
+{
+   using clock = std::chrono::steady_clock;
+   const auto elapsed = [](clock::time_point t0) { return std::chrono::duration<double>(clock::now() - t0).count(); };
+
+   pipeline_result r{Engine::name, records};
+   async_io::channel<uint32_t> free_writes{};
+   async_io::channel<pipeline_event> to_io{};
+   async_io::channel<pipeline_chunk> to_decode{};
+   for (uint32_t i = 0; i < pipeline_slots; ++i) {
+      free_writes.push(i);
+   }
+   std::atomic<bool> failed{};
+   size_t decoded = 0;
+   const auto start = clock::now();
+
+   // Busy time excludes waiting for a free buffer
+   std::thread serializer([&] {
+      const auto obj = make_obj();
+      std::string record{};
+      pipeline_chunk chunk{*free_writes.pop()};
+      auto t0 = clock::now();
+      for (size_t i = 0; i < records && !failed; ++i) {
+         Codec::encode(obj, record);
+         const auto size = record_log::prefix_size + record.size();
+         if (size > pipeline_chunk_size) {
+            failed = true;
+            break;
+         }
+         if (chunk.length + size > pipeline_chunk_size) {
+            r.busy[0] += elapsed(t0);
+            to_io.push({pipeline_event::filled, chunk});
+            const auto offset = chunk.offset + chunk.length;
+            chunk = {*free_writes.pop(), 0, offset};
+            t0 = clock::now();
+         }
+         auto* out = slots[chunk.slot].data() + chunk.length;
+         record_log::put_prefix(out, uint32_t(record.size()));
+         std::memcpy(out + record_log::prefix_size, record.data(), record.size());
+         chunk.length += uint32_t(size);
+         ++chunk.records;
+      }
+      r.busy[0] += elapsed(t0);
+      if (chunk.records) {
+         to_io.push({pipeline_event::filled, chunk});
+      }
+      to_io.push({pipeline_event::finished});
+   });
+
+   std::thread deserializer([&] {
+      obj_t dst{};
+      while (const auto chunk = to_decode.pop()) {
+         const auto t0 = clock::now();
+         std::string_view in{slots[chunk->slot].data(), chunk->length};
+         while (in.size() >= record_log::prefix_size) {
+            const auto size = record_log::get_prefix(in.data());
+            in.remove_prefix(record_log::prefix_size);
+            if (in.size() < size || !Codec::decode(in.substr(0, size), dst)) {
+               failed = true;
+               break;
+            }
+            in.remove_prefix(size);
+            ++decoded;
+         }
+         r.busy[3] += elapsed(t0);
+         to_io.push({pipeline_event::read_slot_free, {chunk->slot}});
+      }
+   });
+
+   // The I/O stages run on this thread. A stage is busy while at least one of its requests is in flight.
+   std::vector<pipeline_chunk> chunks{}; // by chunk id, slot is the buffer currently holding the chunk
+   std::deque<size_t> unread{}; // written chunks waiting for a free read buffer
+   std::vector<uint32_t> free_reads{};
+   for (uint32_t i = pipeline_slots; i < 2 * pipeline_slots; ++i) {
+      free_reads.push_back(i);
+   }
+   std::array<size_t, 2> in_flight{}; // writes, reads
+   std::array<clock::time_point, 2> busy_since{};
+   bool finished = false;
+   const auto begin_io = [&](size_t stage) {
+      if (in_flight[stage - 1]++ == 0) {
+         busy_since[stage - 1] = clock::now();
+      }
+   };
+   const auto end_io = [&](size_t stage) {
+      if (--in_flight[stage - 1] == 0) {
+         r.busy[stage] += elapsed(busy_since[stage - 1]);
+      }
+   };
+   const auto handle = [&](const pipeline_event& e) {
+      if (e.kind == pipeline_event::filled) {
+         const auto id = chunks.size();
+         chunks.push_back(e.chunk);
+         engine.submit({async_io::op::write, e.chunk.slot, e.chunk.length, e.chunk.offset, id * 2});
+         begin_io(1);
+         r.bytes += e.chunk.length;
+      }
+      else if (e.kind == pipeline_event::read_slot_free) {
+         free_reads.push_back(e.chunk.slot);
+      }
+      else {
+         finished = true;
+      }
+   };
+
+   while (!finished || in_flight[0] || in_flight[1] || !unread.empty()) {
+      while (!unread.empty() && !free_reads.empty()) {
+         const auto id = unread.front();
+         unread.pop_front();
+         auto& chunk = chunks[id];
+         chunk.slot = free_reads.back();
+         free_reads.pop_back();
+         engine.submit({async_io::op::read, chunk.slot, chunk.length, chunk.offset, id * 2 + 1});
+         begin_io(2);
+      }
+      if (in_flight[0] + in_flight[1] == 0) {
+         handle(*to_io.pop()); // nothing to complete, wait for the serializer or deserializer
+      }
+      else {
+         const auto c = engine.wait();
+         const auto id = c.tag / 2;
+         if (id >= chunks.size()) {
+            failed = true; // the engine itself failed, in-flight requests cannot be accounted for
+            break;
+         }
+         const auto& chunk = chunks[id];
+         const bool ok = c.result == int64_t(chunk.length);
+         failed = failed || !ok;
+         if (c.tag % 2 == 0) {
+            end_io(1);
+            free_writes.push(chunk.slot);
+            if (ok) {
+               unread.push_back(id);
+            }
+         }
+         else {
+            end_io(2);
+            if (ok) {
+               to_decode.push(chunk);
+            }
+            else {
+               free_reads.push_back(chunk.slot);
+            }
+         }
+      }
+      while (const auto e = to_io.try_pop()) {
+         handle(*e);
+      }
+   }
+
+   to_decode.close();
+   if (failed) {
+      for (uint32_t i = 0; i < pipeline_slots; ++i) {
+         free_writes.push(i); // unblock the serializer
+      }
+   }
+   serializer.join();
+   deserializer.join();
+   r.seconds = elapsed(start);
+   r.ok = !failed && decoded == records;
+   return r;
+}
+
+// One pass on a fresh file, through io_uring when requested and available
+template <class Codec>
+pipeline_result run_pipeline_pass(size_t records, [[maybe_unused]] bool use_uring)
+{
+   const std::string path = "pipeline_" + std::string(Codec::id) + ".log";
+   const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0) {
+      std::cerr << Codec::name << " cannot create " << path << "\n";
+      return {};
+   }
+   std::vector<std::vector<char>> slots(2 * pipeline_slots, std::vector<char>(pipeline_chunk_size));
+   std::vector<iovec> buffers{};
+   for (auto& slot : slots) {
+      buffers.push_back({slot.data(), slot.size()});
+   }
+
+   pipeline_result r{};
+#ifdef BINARY_PERF_IO_URING
+   if (use_uring) {
+      async_io::uring_engine engine{fd, buffers, 2 * pipeline_slots};
+      if (engine.ok()) {
+         r = run_pipeline_stages<Codec>(engine, slots, records);
+      }
+   }
+#endif
+   if (r.engine.empty()) {
+      async_io::thread_pool_engine engine{fd, buffers};
+      r = run_pipeline_stages<Codec>(engine, slots, records);
+   }
+   ::close(fd);
+   std::remove(path.c_str());
+   return r;
+}
+
+// The pass with the median wall time
+template <class Codec>
+pipeline_result run_pipeline(size_t records, bool use_uring)
+{
+   std::vector<pipeline_result> passes{};
+   for (size_t pass = 0; pass < pipeline_passes; ++pass) {
+      passes.push_back(run_pipeline_pass<Codec>(records, use_uring));
+      if (!passes.back().ok) {
+         std::cerr << Codec::name << " pipeline error!\n";
+         return passes.back();
+      }
+   }
+   std::sort(passes.begin(), passes.end(), [](const auto& a, const auto& b) { return a.seconds < b.seconds; });
+   return passes[passes.size() / 2];
+}
+
+} // namespace
+
+pipeline_test_result pipeline_test(size_t records, bool use_uring)
+{
+   return map_formats([&](auto c) { return run_pipeline<decltype(c)>(records, use_uring); });
+}
+
+void write_pipeline_section(std::ostream& out, const report& rep)
+{
+   if (!rep.pipeline) {
+      return;
+   }
+   const auto& p = *rep.pipeline;
+
+   out << "\n## Pipelined Serialize, Write, Read, Deserialize\n\n";
+   out << "Each format encodes " << p.front().records << " Complex Nested Object records, framed as in the streaming ";
+   out << "test, into " << pipeline_slots << " buffers of " << format_size(pipeline_chunk_size) << " on one thread. ";
+   out << "An I/O thread writes every full buffer to a file with " << p.front().engine << " and reads it back into a ";
+   out << "second set of " << pipeline_slots << " buffers as soon as the write completes, and a third thread decodes ";
+   out << "the records into `obj_t`, so all four stages overlap. Throughput is end to end for the pass with the median ";
+   out << "wall time out of " << pipeline_passes << ". Each stage column is the share of the wall time that stage was ";
+   out << "busy (for I/O, with at least one request in flight); the busiest stage bounds the pipeline. The file is not ";
+   out << "fsync'ed, so reads are usually served from the page cache.\n\n";
+
+   out << "| Format | Throughput | Serialize | Write | Read | Deserialize | Bottleneck |\n";
+   out << "|--------|------------|-----------|-------|------|-------------|------------|\n";
+   for (size_t f = 0; f < format_count; ++f) {
+      const auto& r = p[f];
+      if (!r.ok) {
+         out << "| " << format_names[f] << " | error | | | | | |\n";
+         continue;
+      }
+      out << "| " << format_names[f] << " | " << format_stream_rate(r.records, r.bytes, r.seconds) << " |";
+      for (const auto busy : r.busy) {
+         out << " " << std::fixed << std::setprecision(0) << (100.0 * busy / r.seconds) << "% |";
+      }
+      out << " " << pipeline_stages[r.bottleneck()] << " |\n";
+   }
+}
@@ -0,0 +1,198 @@
+// Pre-filter stage for numeric arrays (prefilter.hpp) around any vector codec: before every write the values are
+// filtered into the bench's source vector, and read runs the same steps in reverse into `decoded`. The entropy stage
+// (entropy.hpp) is deflate_codec around the same codec. JSON is not filtered because filtered doubles are arbitrary
+// bit patterns, including NaNs, which JSON cannot carry.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "entropy.hpp"
+#include "prefilter.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+template <class Codec, class T>
+struct filtered_bench
+{
+   codec_bench<Codec, std::vector<T>> bench;
+   prefilter::pipeline filter{};
+   std::vector<T> values{};
+   std::vector<T> decoded{};
+   std::vector<T> scratch{};
+
+   filtered_bench(const std::vector<T>& source, prefilter::pipeline filter)
+      : bench(source), filter(filter), values(source)
+   {
+      write();
+   }
+
+   void write()
+   {
+      prefilter::encode<T>(filter, values, bench.value, scratch);
+      bench.write();
+   }
+
+   bool read()
+   {
+      if (!bench.read()) {
+         return false;
+      }
+      prefilter::decode<T>(filter, bench.dst, decoded, scratch);
+      return true;
+   }
+
+   uint64_t size() const { return bench.size(); }
+};
+
+// Slowly varying samples typical of telemetry: a noisy sine for floating point types, jittered monotonically
+// increasing nanosecond timestamps for integers
+template <class T>
+std::vector<T> telemetry_vector(size_t n = vector_size)
+{
+   std::mt19937_64 gen{};
+   std::vector<T> x(n);
+   if constexpr (std::is_floating_point_v<T>) {
+      std::normal_distribution<double> noise{0.0, 0.01};
+      for (size_t i = 0; i < n; ++i) {
+         x[i] = T(20.0 + 5.0 * std::sin(double(i) / 100.0) + noise(gen));
+      }
+   }
+   else {
+      std::uniform_int_distribution<uint64_t> jitter{0, 1000};
+      uint64_t t = uint64_t(1'700'000'000) * 1'000'000'000;
+      for (auto& v : x) {
+         t += 1'000'000 + jitter(gen);
+         v = T(t);
+      }
+   }
+   return x;
+}
+
+template <class Codec, class T>
+results run_filtered(const std::vector<T>& values, prefilter::pipeline filter)
+{
+   filtered_bench<Codec, T> bench{values, filter};
+   if (!bench.read() || bench.decoded != values) {
+      std::cerr << Codec::name << " (" << filter.name() << ") round trip error!\n";
+      return {};
+   }
+   return run_bench(bench, Codec::name);
+}
+
+template <class T>
+prefilter_point run_prefilter(const std::vector<T>& values, prefilter::pipeline filter, bool compress)
+{
+   prefilter_point p{filter, compress, {}};
+   const auto run = [&](auto c) {
+      using C = decltype(c);
+      if constexpr (!std::same_as<C, json_codec>) {
+         p.formats[format_index<C>] =
+            compress ? run_filtered<deflate_codec<C>>(values, filter) : run_filtered<C>(values, filter);
+      }
+   };
+   std::apply([&](auto... c) { (run(c), ...); }, formats{});
+   return p;
+}
+
+template <class T>
+prefilter_result prefilter_payload(std::string name, const std::vector<T>& values)
+{
+   using prefilter::difference;
+   prefilter_result r{std::move(name), {}};
+   for (const bool compress : {false, true}) {
+      if (compress && !entropy::available) {
+         break;
+      }
+      for (const auto diff : {difference::none, difference::delta, difference::xor_previous}) {
+         for (const bool shuffle : {false, true}) {
+            const prefilter::pipeline filter{diff, shuffle};
+            std::cout << "  " << r.name << ": " << filter.name() << (compress ? " + deflate" : "") << "\n";
+            r.points.push_back(run_prefilter(values, filter, compress));
+         }
+      }
+   }
+   return r;
+}
+
+// Filtered message size relative to the plain codec, extra write/read time per message, and the link bandwidth
+// below which the saved bytes pay for the extra time (write + transfer + read)
+std::string format_filtered(const results& r, const results& plain)
+{
+   if (&r == &plain) {
+      return format_size(r.size) + " · " + format_time(r.write.median()) + "/" + format_time(r.read.median());
+   }
+   const auto signed_time = [](double seconds) {
+      return (seconds < 0 ? "-" : "+") + format_time(std::abs(seconds));
+   };
+   std::ostringstream oss;
+   oss << format_size(r.size) << " (" << std::fixed << std::setprecision(1)
+       << (plain.size ? 100.0 * double(r.size) / double(plain.size) : 0.0) << "%) · ";
+   oss << signed_time(r.write.median() - plain.write.median()) << "/"
+       << signed_time(r.read.median() - plain.read.median()) << " · ";
+   const auto saved = double(plain.size) - double(r.size);
+   const auto extra = (r.write.median() + r.read.median()) - (plain.write.median() + plain.read.median());
+   if (saved <= 0) {
+      oss << "never";
+   }
+   else if (extra <= 0) {
+      oss << "always";
+   }
+   else {
+      oss << "< " << format_throughput(uint64_t(saved), extra);
+   }
+   return oss.str();
+}
+
+} // namespace
+
+std::vector<prefilter_result> prefilter_test()
+{
+   return {prefilter_payload("std::vector<double>, uniform", random_vector<double>()),
+           prefilter_payload("std::vector<double>, telemetry", telemetry_vector<double>()),
+           prefilter_payload("std::vector<uint64_t>, uniform", random_vector<uint64_t>()),
+           prefilter_payload("std::vector<uint64_t>, telemetry", telemetry_vector<uint64_t>())};
+}
+
+void write_prefilter_section(std::ostream& out, const report& rep)
+{
+   const auto& prefilter = rep.prefilter;
+   if (prefilter.empty()) {
+      return;
+   }
+
+   out << "\n## Numeric Array Pre-Filters\n\n";
+   out << "Vectors of " << vector_size << " elements are filtered before the codec encodes them and unfiltered after ";
+   out << "it decodes them. `delta` subtracts and `xor` xors each element's bit pattern with the previous one; ";
+   out << "`shuffle` splits the array into byte planes like Blosc. ";
+   if (entropy::available) {
+      out << "`deflate` compresses the encoded message with zlib at its fastest level. ";
+   }
+   else {
+      out << "The entropy stage was skipped because the build has no zlib. ";
+   }
+   out << "The first row is the plain codec (size, write/read time). Other cells give the message size and its share ";
+   out << "of the plain size, the extra write/read time per message, and the link bandwidth below which sending ";
+   out << "the smaller message is faster end to end, i.e. when spending the CPU time pays off. ";
+   out << "Uniform data spans the whole value range; telemetry is a noisy sine (floating point) or jittered ";
+   out << "nanosecond timestamps (integers). JSON is n/a because it cannot carry the filtered bit patterns.\n";
+
+   for (const auto& r : prefilter) {
+      out << "\n### " << r.name << "\n\n";
+      write_format_header(out, {"Filter"});
+      const auto& plain = r.points.front();
+      for (const auto& p : r.points) {
+         write_format_row(out, p.filter.name() + (p.compressed ? " + deflate" : ""), [&](size_t f) {
+            const auto& filtered = p.formats[f];
+            return filtered && plain.formats[f] ? format_filtered(*filtered, *plain.formats[f]) : "n/a";
+         });
+      }
+   }
+}
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "loopback.hpp"
+#include "measure.hpp"
+#include "prefilter.hpp"
+#include "scaling.hpp"
+
+#include "bench.hpp"
+
+// Results of every mode and the report built from them. Each mode lives in its own translation unit with its
+// *_test() and write_*_section(); a per-format result is an array indexed like formats (codecs.hpp), and a format a
+// mode cannot run is left empty and shown as n/a.
+
+using format_results = std::array<results, format_count>;
+
+struct benchmark_result
+{
+   std::string name;
+   format_results formats;
+};
+
+struct roofline_result
+{
+   results raw; // the raw struct codec on the same value
+   roofline_point raw_copy;
+   std::array<roofline_point, format_count> formats; // on each format's message size
+};
+
+// The same MessagePack bytes decoded with each msgpack-c strategy, plus Glaze's MessagePack codec
+using msgpack_strategies = std::tuple<msgpack_zone_codec, msgpack_visitor_codec, glaze_msgpack_codec>;
+using msgpack_strategy_result = std::array<results, std::tuple_size_v<msgpack_strategies>>;
+
+// Zero-copy view reads of the complex object
+using view_result = std::array<std::optional<measurement>, format_count>;
+
+struct field_access
+{
+   uint64_t size{};
+   measurement full{}; // complete decode into obj_t
+   measurement number{};
+   measurement id{};
+};
+
+struct field_point
+{
+   size_t elements;
+   std::array<std::optional<field_access>, format_count> formats;
+};
+
+struct stream_result
+{
+   size_t records{};
+   uint64_t bytes{}; // log size including length prefixes
+   double write{}; // seconds per pass, median over the passes
+   double read{};
+   double mmap{};
+};
+
+using stream_test_result = std::array<stream_result, format_count>;
+
+struct pipeline_result
+{
+   std::string_view engine;
+   size_t records{};
+   uint64_t bytes{};
+   double seconds{}; // wall time from the first encode to the last decode
+   std::array<double, 4> busy{}; // seconds each pipeline stage was working
+   bool ok{};
+
+   // The stage with the highest utilization
+   size_t bottleneck() const { return size_t(std::max_element(busy.begin(), busy.end()) - busy.begin()); }
+};
+
+using pipeline_test_result = std::array<pipeline_result, format_count>;
+
+struct rpc_point
+{
+   loopback::transport transport{};
+   size_t clients{};
+   uint64_t requests{}; // including warmup
+   double seconds{};
+   latency_histogram rtt{};
+   latency_histogram codec{};
+   latency_histogram transfer{}; // rtt minus codec
+   bool ok{};
+};
+
+struct rpc_result
+{
+   std::string name;
+   std::vector<rpc_point> points; // by transport, then concurrency
+};
+
+struct arena_result
+{
+   std::string codec;
+   uint64_t size{};
+   measurement heap_read{};
+   std::optional<measurement> arena_read{}; // unset when the codec cannot decode the pmr types
+   measurement new_write{}; // into a new std::string every time
+   measurement reused_write{};
+   std::optional<measurement> fixed_write{}; // unset when the codec only writes into resizable buffers
+};
+
+struct evolution_point
+{
+   std::string_view variant;
+   size_t unknown{}; // elements per unknown field, 0 for the variants without unknown fields
+   uint64_t size{};
+   measurement read{};
+   bool ok{}; // decoded to the expected obj_t
+};
+
+struct evolution_result
+{
+   std::string codec;
+   std::vector<evolution_point> points; // same schema, reordered, missing, then one per unknown field size
+};
+
+struct validation_point
+{
+   uint64_t size{};
+   measurement validate{};
+   measurement decode{}; // into a reused destination, as Read in the other tests
+   bool ok{};
+};
+
+struct validation_result
+{
+   std::string name;
+   std::array<validation_point, format_count> formats{};
+};
+
+// JSON is not filtered, see prefilter.cpp
+struct prefilter_point
+{
+   prefilter::pipeline filter;
+   bool compressed;
+   std::array<std::optional<results>, format_count> formats;
+};
+
+struct prefilter_result
+{
+   std::string name;
+   std::vector<prefilter_point> points; // the first point is the plain codec
+};
+
+// Value distributions for the vector tests. full_range is random_vector, the worst case for variable-length integers;
+// the others model common data: small counters, Zipfian IDs, sorted timestamps and mostly-zero sparse arrays.
+enum struct distribution : uint8_t { full_range, small, zipf, monotonic, sparse_zero };
+
+constexpr std::array<distribution, 5> all_distributions{distribution::full_range, distribution::small,
+                                                         distribution::zipf, distribution::monotonic,
+                                                         distribution::sparse_zero};
+
+constexpr std::string_view distribution_name(distribution d)
+{
+   switch (d) {
+   case distribution::full_range:
+      return "full range";
+   case distribution::small:
+      return "small";
+   case distribution::zipf:
+      return "zipf";
+   case distribution::monotonic:
+      return "monotonic";
+   case distribution::sparse_zero:
+      return "sparse zero";
+   }
+   return "unknown";
+}
+
+struct distribution_point
+{
+   distribution dist;
+   format_results formats;
+};
+
+struct distribution_result
+{
+   std::string name;
+   std::vector<distribution_point> points;
+};
+
+// One container per format, or concatenated frames (framed_codec)
+struct batch_point
+{
+   size_t count;
+   bool framed;
+   format_results formats;
+};
+
+// One format on one point count in both layouts
+struct layout_pair
+{
+   results aos;
+   results soa;
+};
+
+struct layout_point
+{
+   size_t points;
+   std::array<layout_pair, format_count> formats;
+};
+
+struct scaling_series
+{
+   size_t iterations{}; // per thread, calibrated on one thread
+   std::vector<scaling_point> points;
+};
+
+struct scaling_result
+{
+   std::string name;
+   std::array<scaling_series, format_count> formats;
+};
+
+struct sweep_point
+{
+   size_t elements;
+   format_results formats;
+   roofline_point roofline{}; // on the raw (in-memory) array size, shared by every format
+};
+
+struct sweep_result
+{
+   std::string name;
+   size_t element_size;
+   std::vector<sweep_point> points;
+};
+
+// The pool behind one format's cold run
+struct cold_pool
+{
+   size_t count{};
+   uint64_t footprint{}; // live bytes of one bench after a read: the bench, its buffer and both values
+};
+
+struct cold_result
+{
+   std::string name;
+   format_results formats;
+   std::array<cold_pool, format_count> pools{};
+};
+
+struct varied_result
+{
+   std::string name;
+   format_results formats;
+};
+
+struct matrix_cell
+{
+   std::string codec;
+   std::string payload;
+   size_t size{};
+   results result;
+};
+
+// Comma separated ids and sizes from the command line; an empty list selects everything, sizes replace the defaults
+struct matrix_filter
+{
+   std::vector<std::string> codecs;
+   std::vector<std::string> payloads;
+   std::vector<size_t> sizes;
+
+   bool selects(std::string_view codec, std::string_view payload) const
+   {
+      return (codecs.empty() || std::ranges::find(codecs, codec) != codecs.end()) &&
+             (payloads.empty() || std::ranges::find(payloads, payload) != payloads.end());
+   }
+};
+
+// String lengths of the payload families
+enum struct string_length : uint8_t { short_words, log_lines, uniform, long_text };
+
+constexpr std::array<string_length, 4> all_string_lengths{string_length::short_words, string_length::log_lines,
+                                                          string_length::uniform, string_length::long_text};
+
+// Selects the distribution on the command line
+constexpr std::string_view string_length_id(string_length l)
+{
+   switch (l) {
+   case string_length::short_words:
+      return "short";
+   case string_length::log_lines:
+      return "log";
+   case string_length::uniform:
+      return "uniform";
+   case string_length::long_text:
+      return "long";
+   }
+   return "unknown";
+}
+
+struct report
+{
+   std::vector<benchmark_result> results;
+   std::vector<roofline_result> roofline; // one per entry of results, except the payload families at the end
+   std::vector<scaling_result> scaling;
+   std::vector<sweep_result> sweep;
+   std::vector<cold_result> cold;
+   uint64_t cold_pool_bytes{};
+   bool cold_shuffled{};
+   std::vector<varied_result> varied;
+   size_t varied_payloads{};
+   std::optional<view_result> views;
+   std::vector<field_point> fields;
+   std::optional<stream_test_result> stream;
+   std::optional<pipeline_test_result> pipeline;
+   std::vector<rpc_result> rpc;
+   std::vector<arena_result> arena;
+   std::vector<evolution_result> evolution;
+   std::vector<validation_result> validation;
+   std::vector<prefilter_result> prefilter;
+   std::vector<distribution_result> distributions;
+   std::vector<batch_point> batches;
+   std::vector<layout_point> layouts;
+   std::optional<::results> protobuf_direct;
+   std::optional<msgpack_strategy_result> msgpack_strategies;
+   std::vector<matrix_cell> matrix;
+};
+
+// The modes. Each runs every format, or every codec of all_codecs that handles its payloads, through codec_bench.
+
+// The complex object and the vector payloads, with the raw floor, Protobuf Direct, the msgpack-c strategies and the
+// zero-copy views
+void fixed_tests(report& rep);
+view_result view_test();
+std::vector<benchmark_result> family_test(size_t max_entries, const std::vector<string_length>& lengths);
+std::vector<field_point> field_access_test(size_t max_elements);
+stream_test_result stream_test(size_t records);
+pipeline_test_result pipeline_test(size_t records, bool use_uring);
+std::vector<rpc_result> rpc_test();
+std::vector<arena_result> arena_test();
+std::vector<evolution_result> evolution_test();
+std::vector<validation_result> validation_test();
+std::vector<prefilter_result> prefilter_test();
+std::vector<distribution_result> distribution_test();
+std::vector<batch_point> batch_test();
+std::vector<layout_point> layout_test(size_t max_points);
+std::vector<scaling_result> scaling_test(size_t max_threads);
+std::vector<sweep_result> sweep_test(size_t max_elements);
+std::vector<cold_result> cold_test(uint64_t pool_bytes, bool shuffle);
+std::vector<varied_result> varied_test(size_t payloads);
+std::vector<matrix_cell> matrix_test(const matrix_filter& filter);
+
+// Every codec and payload id with the sizes it runs at by default
+void list_matrix();
+
+// Report sections, each empty when its mode did not run
+void write_roofline_section(std::ostream& out, const report& rep);
+void write_protobuf_direct_section(std::ostream& out, const report& rep);
+void write_msgpack_strategy_section(std::ostream& out, const report& rep);
+void write_view_section(std::ostream& out, const report& rep);
+void write_field_section(std::ostream& out, const report& rep);
+void write_stream_section(std::ostream& out, const report& rep);
+void write_pipeline_section(std::ostream& out, const report& rep);
+void write_rpc_section(std::ostream& out, const report& rep);
+void write_arena_section(std::ostream& out, const report& rep);
+void write_evolution_section(std::ostream& out, const report& rep);
+void write_validation_section(std::ostream& out, const report& rep);
+void write_prefilter_section(std::ostream& out, const report& rep);
+void write_distribution_section(std::ostream& out, const report& rep);
+void write_batch_section(std::ostream& out, const report& rep);
+void write_layout_section(std::ostream& out, const report& rep);
+void write_matrix_section(std::ostream& out, const report& rep);
+void write_scaling_section(std::ostream& out, const report& rep);
+void write_sweep_section(std::ostream& out, const report& rep);
+void write_cold_section(std::ostream& out, const report& rep);
+void write_varied_section(std::ostream& out, const report& rep);
+
+void generate_markdown(const report& rep, const std::string& filename);
+void write_sweep_csv(const report& rep, const std::string& filename);
+
+// Machine-readable results for the compare mode, and the comparison of two of them (compare.cpp)
+void write_results_json(const report& rep, const std::string& filename);
+int compare_runs(const std::string& baseline_file, const std::string& candidate_file, double threshold_percent);
@@ -0,0 +1,180 @@
+// Loopback RPC: closed-loop clients, each on its own connection and thread, send the complex object to an echo
+// server thread that decodes it, encodes it again and replies. Every round trip is split into codec time (client
+// encode and decode plus server decode and encode) and transport time (the rest: syscalls, the kernel socket path and
+// thread wakeups). Client i is paired with server thread i, so request k of both sides is the same round trip.
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "loopback.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr std::array<size_t, 3> rpc_concurrency{1, 4, 16};
+constexpr std::array<loopback::transport, 2> rpc_transports{loopback::transport::unix_socket,
+                                                            loopback::transport::tcp};
+constexpr size_t rpc_warmup_requests = 100; // per client, left out of the latency histograms
+
+template <class Codec>
+rpc_point run_rpc(loopback::transport transport, size_t clients)
+{
+   using clock = std::chrono::steady_clock;
+   const auto ns = [](clock::time_point a, clock::time_point b) {
+      return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+   };
+
+   rpc_point p{transport, clients};
+   loopback::listener listener{transport, "rpc_" + std::string(Codec::id) + ".sock"};
+   if (!listener.ok()) {
+      std::cerr << Codec::name << " cannot listen on a " << loopback::transport_name(transport) << "\n";
+      return p;
+   }
+   std::vector<loopback::connection> client_ends(clients);
+   std::vector<loopback::connection> server_ends(clients);
+   for (size_t i = 0; i < clients; ++i) {
+      client_ends[i] = listener.connect();
+      server_ends[i] = listener.accept();
+      if (!client_ends[i].ok() || !server_ends[i].ok()) {
+         std::cerr << Codec::name << " cannot connect over a " << loopback::transport_name(transport) << "\n";
+         return p;
+      }
+   }
+
+   // Per request nanoseconds: client round trip, client codec, server codec
+   std::vector<std::vector<uint64_t>> rtt(clients), client_codec(clients), server_codec(clients);
+   std::atomic<bool> failed{};
+   std::vector<std::thread> threads;
+   for (size_t i = 0; i < clients; ++i) {
+      threads.emplace_back([&, i] {
+         obj_t obj{};
+         std::string in, out;
+         while (server_ends[i].receive(in)) {
+            const auto t0 = clock::now();
+            failed = !Codec::decode(in, obj) || failed;
+            Codec::encode(obj, out);
+            server_codec[i].push_back(ns(t0, clock::now()));
+            if (!server_ends[i].send(out)) {
+               failed = true;
+               break;
+            }
+         }
+         server_ends[i].finish(); // a client still waiting for a reply sees the end of the stream
+      });
+   }
+   const auto start = clock::now();
+   const auto deadline = start + std::chrono::duration<double>(measure_defaults.target_seconds);
+   for (size_t i = 0; i < clients; ++i) {
+      threads.emplace_back([&, i] {
+         const auto obj = make_obj();
+         obj_t dst{};
+         std::string request, reply;
+         auto& c = client_ends[i];
+         while (clock::now() < deadline) {
+            const auto t0 = clock::now();
+            Codec::encode(obj, request);
+            const auto t1 = clock::now();
+            if (!c.send(request) || !c.receive(reply)) {
+               failed = true;
+               break;
+            }
+            const auto t2 = clock::now();
+            failed = !Codec::decode(reply, dst) || failed;
+            const auto t3 = clock::now();
+            rtt[i].push_back(ns(t0, t3));
+            client_codec[i].push_back(ns(t0, t1) + ns(t2, t3));
+         }
+         c.finish();
+      });
+   }
+   for (auto& t : threads) {
+      t.join();
+   }
+   p.seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+   for (size_t i = 0; i < clients; ++i) {
+      p.requests += rtt[i].size();
+      for (size_t k = rpc_warmup_requests; k < rtt[i].size() && k < server_codec[i].size(); ++k) {
+         const auto codec = client_codec[i][k] + server_codec[i][k];
+         p.rtt.record(rtt[i][k]);
+         p.codec.record(codec);
+         p.transfer.record(rtt[i][k] > codec ? rtt[i][k] - codec : 0);
+      }
+   }
+   p.ok = !failed;
+   if (failed) {
+      std::cerr << Codec::name << " RPC error over a " << loopback::transport_name(transport) << "!\n";
+   }
+   return p;
+}
+
+// p50 / p99 / p99.9 of a latency histogram
+std::string format_percentiles(const latency_histogram& h)
+{
+   return format_time(h.percentile(0.5) * 1e-9) + " / " + format_time(h.percentile(0.99) * 1e-9) + " / " +
+          format_time(h.percentile(0.999) * 1e-9);
+}
+
+} // namespace
+
+// Every registered codec that handles obj_t, over each transport and client count
+std::vector<rpc_result> rpc_test()
+{
+   std::vector<rpc_result> results;
+   const auto run = [&](auto c) {
+      using C = decltype(c);
+      if constexpr (codec<C, obj_t>) {
+         if (codec_enabled<C>()) {
+            std::cout << "  " << C::name << "\n";
+            auto& r = results.emplace_back(std::string(C::name));
+            for (const auto transport : rpc_transports) {
+               for (const auto clients : rpc_concurrency) {
+                  r.points.push_back(run_rpc<C>(transport, clients));
+               }
+            }
+         }
+      }
+   };
+   std::apply([&](auto... c) { (run(c), ...); }, all_codecs{});
+   return results;
+}
+
+void write_rpc_section(std::ostream& out, const report& rep)
+{
+   const auto& rpc = rep.rpc;
+   if (rpc.empty()) {
+      return;
+   }
+
+   out << "\n## Loopback RPC Latency\n\n";
+   out << "Each client thread sends the Complex Nested Object over its own connection, length-framed as in the ";
+   out << "streaming test, and waits for the reply before sending the next request. A server thread per connection ";
+   out << "decodes the request into `obj_t`, encodes it again and replies. Every run lasts "
+       << measure_defaults.target_seconds << " s; the first " << rpc_warmup_requests
+       << " round trips per client are left out of the percentiles. ";
+   out << "Codec is client encode + server decode and encode + client decode of the same round trip, Transport is ";
+   out << "the rest of the round trip (syscalls, the kernel socket path and thread wakeups). Times are p50 / p99 / ";
+   out << "p99.9.\n\n";
+
+   out << "| Format | Transport | Clients | Requests/s | Round Trip | Codec | Transport Time |\n";
+   out << "|--------|-----------|---------|------------|------------|-------|----------------|\n";
+   for (const auto& r : rpc) {
+      for (const auto& p : r.points) {
+         out << "| " << r.name << " | " << loopback::transport_name(p.transport) << " | " << p.clients << " | ";
+         if (!p.ok || p.seconds <= 0) {
+            out << "error | | | |\n";
+            continue;
+         }
+         out << std::fixed << std::setprecision(0) << (double(p.requests) / p.seconds) << " | "
+             << format_percentiles(p.rtt) << " | " << format_percentiles(p.codec) << " | "
+             << format_percentiles(p.transfer) << " |\n";
+      }
+   }
+}
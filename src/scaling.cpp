@@ -0,0 +1,90 @@
+// Multi-threaded scaling: the complex object and the 10K element vectors on 1, 2, 4, ... pinned threads, each with
+// its own codec_bench, see scaling.hpp
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "scaling.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+// The iteration count per thread is calibrated once on the calling thread, so that the write and the read loop
+// each take about measure_defaults.target_seconds on one thread
+template <class T>
+scaling_result run_scaling(std::string name, const T& value, size_t max_threads)
+{
+   std::cout << "  " << name << "\n";
+   scaling_result r{std::move(name), {}};
+   const auto run = [&](auto c) {
+      using C = decltype(c);
+      auto& s = r.formats[format_index<C>];
+      codec_bench<C, T> probe{value};
+      s.iterations = calibrate_iterations(
+         [&] {
+            probe.write();
+            probe.read();
+         },
+         2 * measure_defaults.target_seconds, 1);
+      for (auto n : thread_counts(max_threads)) {
+         s.points.push_back(run_scaled(n, s.iterations, [&] { return codec_bench<C, T>{value}; }));
+      }
+   };
+   std::apply([&](auto... c) { (run(c), ...); }, formats{});
+   return r;
+}
+
+// Aggregate throughput of all threads, and the same as a fraction of perfect linear scaling from one thread
+std::string format_scaling(const scaling_point& p, const scaling_point& single, size_t iters)
+{
+   const auto ops = double(iters * p.threads);
+   const auto write_eff = single.write / p.write;
+   const auto read_eff = single.read / p.read;
+   std::ostringstream oss;
+   oss << format_throughput(p.size, p.write / ops) << " / " << format_throughput(p.size, p.read / ops) << " ("
+       << std::fixed << std::setprecision(0) << (100.0 * write_eff) << "% / " << (100.0 * read_eff) << "%)";
+   return oss.str();
+}
+
+} // namespace
+
+std::vector<scaling_result> scaling_test(size_t max_threads)
+{
+   std::vector<scaling_result> results;
+   results.push_back(run_scaling("Complex Nested Object", make_obj(), max_threads));
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      results.push_back(run_scaling("std::vector<" + std::string(type) + "> (10K)", random_vector<T>(), max_threads));
+   });
+   return results;
+}
+
+void write_scaling_section(std::ostream& out, const report& rep)
+{
+   if (rep.scaling.empty()) {
+      return;
+   }
+
+   out << "\n## Multi-threaded Scaling\n\n";
+   out << "Each thread is pinned to its own CPU and owns its own objects and buffers. ";
+   out << "Cells show aggregate Write / Read throughput across all threads, followed by per-thread efficiency ";
+   out << "relative to the single-threaded run (100% is perfect linear scaling). Every thread runs the same number ";
+   out << "of iterations, calibrated per format so that each loop takes about " << measure_defaults.target_seconds;
+   out << " s on one thread.\n";
+
+   for (const auto& r : rep.scaling) {
+      out << "\n### " << r.name << "\n\n";
+      write_format_header(out, {"Threads"});
+      const auto& first = r.formats.front().points;
+      for (size_t i = 0; i < first.size(); ++i) {
+         write_format_row(out, std::to_string(first[i].threads), [&](size_t f) {
+            const auto& s = r.formats[f];
+            return format_scaling(s.points[i], s.points.front(), s.iterations);
+         });
+      }
+   }
+}
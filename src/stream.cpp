@@ -0,0 +1,121 @@
+// Streaming file I/O: every pass encodes `records` copies of the complex object into a log of length-prefixed
+// records with buffered write(2), then decodes the whole log once through read(2) and once through mmap(2). Times
+// are wall clock for the whole pass, including syscalls and page-cache copies; nothing is fsync'ed, so the log is
+// typically still in the page cache when it is read back.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#include "record_log.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+constexpr size_t stream_passes = 3;
+
+template <class Reader, class Bench>
+bool decode_log(Reader& reader, Bench& bench, size_t records)
+{
+   size_t n = 0;
+   bool ok = true;
+   std::string_view record;
+   while (reader.next(record)) {
+      ok &= bench.read(record);
+      ++n;
+   }
+   return ok && reader.ok() && n == records;
+}
+
+template <class Codec>
+stream_result run_stream(size_t records)
+{
+   using clock = std::chrono::steady_clock;
+   const auto seconds = [](clock::time_point t0) { return std::chrono::duration<double>(clock::now() - t0).count(); };
+
+   const std::string path = "stream_" + std::string(Codec::id) + ".log";
+   codec_bench<Codec, obj_t> bench{make_obj()};
+   stream_result r{records};
+   std::vector<double> write, read, mmap;
+   for (size_t pass = 0; pass < stream_passes; ++pass) {
+      auto t0 = clock::now();
+      {
+         record_log::writer log{path};
+         for (size_t i = 0; i < records; ++i) {
+            bench.write();
+            log.append(bench.bytes());
+         }
+         if (!log.close()) {
+            std::cerr << Codec::name << " cannot write " << path << "\n";
+            return {};
+         }
+         r.bytes = log.bytes_written();
+      }
+      write.push_back(seconds(t0));
+
+      t0 = clock::now();
+      {
+         record_log::reader log{path};
+         if (!decode_log(log, bench, records)) {
+            std::cerr << Codec::name << " read() decode error!\n";
+         }
+      }
+      read.push_back(seconds(t0));
+
+      t0 = clock::now();
+      {
+         record_log::mapped_reader log{path};
+         if (!decode_log(log, bench, records)) {
+            std::cerr << Codec::name << " mmap decode error!\n";
+         }
+      }
+      mmap.push_back(seconds(t0));
+   }
+   std::remove(path.c_str());
+
+   const auto median = [](std::vector<double>& v) {
+      std::sort(v.begin(), v.end());
+      return v[v.size() / 2];
+   };
+   r.write = median(write);
+   r.read = median(read);
+   r.mmap = median(mmap);
+   return r;
+}
+
+} // namespace
+
+stream_test_result stream_test(size_t records)
+{
+   return map_formats([&](auto c) { return run_stream<decltype(c)>(records); });
+}
+
+void write_stream_section(std::ostream& out, const report& rep)
+{
+   if (!rep.stream) {
+      return;
+   }
+   const auto& s = *rep.stream;
+
+   out << "\n## Streaming File I/O\n\n";
+   out << "Each format writes " << s.front().records << " Complex Nested Object records to a log file, each framed ";
+   out << "by a 4 byte length prefix, through a 1 MB buffer flushed with `write(2)`, then decodes the whole log into ";
+   out << "`obj_t` once through `read(2)` into a 1 MB buffer and once through an `mmap(2)`ed view of the file. ";
+   out << "Rates are the median of " << stream_passes << " passes and include encoding or decoding, framing, ";
+   out << "syscalls and page-cache copies. The log is not fsync'ed, so reads are usually served from the page cache.\n\n";
+
+   write_format_header(out, {"Metric"});
+   write_format_row(out, "Log Size", [&](size_t f) { return format_size(s[f].bytes); });
+   const auto write_row = [&](std::string_view metric, double stream_result::*phase) {
+      write_format_row(out, metric,
+                       [&](size_t f) { return format_stream_rate(s[f].records, s[f].bytes, s[f].*phase); });
+   };
+   write_row("Write", &stream_result::write);
+   write_row("Read (`read`)", &stream_result::read);
+   write_row("Read (`mmap`)", &stream_result::mmap);
+}
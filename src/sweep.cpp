@@ -0,0 +1,99 @@
+// Payload-size sweep: every format on each vector type at element counts from 16 up to max_elements, with the
+// memory bandwidth roofline at each point, to show where encoding stops being compute-bound
+
+#include <fstream>
+#include <iostream>
+
+#include "cache_info.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+std::vector<size_t> sweep_sizes(size_t max_elements)
+{
+   std::vector<size_t> sizes;
+   for (size_t n = 16; n < max_elements; n *= 4) {
+      sizes.push_back(n);
+   }
+   sizes.push_back(max_elements);
+   return sizes;
+}
+
+template <class T>
+sweep_result sweep_payload(std::string name, size_t max_elements)
+{
+   sweep_result r{std::move(name), sizeof(T), {}};
+   for (auto n : sweep_sizes(max_elements)) {
+      std::cout << "  " << r.name << " x " << n << "\n";
+      r.points.push_back({n, run_formats(random_vector<T>(n)), run_roofline(n * sizeof(T))});
+   }
+   return r;
+}
+
+} // namespace
+
+std::vector<sweep_result> sweep_test(size_t max_elements)
+{
+   std::vector<sweep_result> results;
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      results.push_back(sweep_payload<T>("std::vector<" + std::string(type) + ">", max_elements));
+   });
+   return results;
+}
+
+void write_sweep_section(std::ostream& out, const report& rep)
+{
+   if (rep.sweep.empty()) {
+      return;
+   }
+
+   const auto& caches = detect_caches();
+   out << "\n## Payload Size Sweep\n\n";
+   out << "Cells show median Write / Read throughput, then the memory bandwidth roofline as a percentage: the time ";
+   out << "the faster of `memcpy` and a streaming copy takes on the raw array, over the time of the operation. The ";
+   out << "roofline is timed once per size and shared by every format, so all formats are held to the same bound. ";
+   out << "Each measurement runs for ";
+   out << "about " << measure_defaults.target_seconds << " s. ";
+   out << "Fits In is the smallest cache level that holds the raw (in-memory) array: L1D " << format_size(caches.l1d)
+       << ", L2 " << format_size(caches.l2) << ", LLC " << format_size(caches.llc) << ". ";
+   out << "Raw data is also written to `sweep.csv`.\n";
+
+   for (const auto& r : rep.sweep) {
+      out << "\n### " << r.name << "\n\n";
+      write_format_header(out, {"Elements", "Raw Size", "Fits In"});
+      for (const auto& p : r.points) {
+         const auto raw = uint64_t(p.elements * r.element_size);
+         const auto label =
+            std::to_string(p.elements) + " | " + format_size(raw) + " | " + std::string(caches.level(raw));
+         write_format_row(out, label, [&](size_t f) {
+            return format_write_read(p.formats[f]) + " (" + format_roofline(p.formats[f], p.roofline) + ")";
+         });
+      }
+   }
+}
+
+void write_sweep_csv(const report& rep, const std::string& filename)
+{
+   std::ofstream out(filename);
+   const auto& caches = detect_caches();
+   out << "type,elements,raw_bytes,fits_in,format,encoded_bytes,write_bytes_per_sec,read_bytes_per_sec,"
+          "roofline_bytes_per_sec,write_pct_of_roofline,read_pct_of_roofline\n";
+   for (const auto& r : rep.sweep) {
+      for (const auto& p : r.points) {
+         const auto raw = uint64_t(p.elements * r.element_size);
+         for (size_t i = 0; i < format_count; ++i) {
+            const auto& f = p.formats[i];
+            const auto best = p.roofline.best();
+            out << '"' << r.name << "\"," << p.elements << ',' << raw << ',' << caches.level(raw) << ','
+                << format_ids[i] << ',' << f.size << ',' << (double(f.size) / f.write.median()) << ','
+                << (double(f.size) / f.read.median()) << ',' << (double(raw) / best) << ','
+                << (100.0 * best / f.write.median()) << ',' << (100.0 * best / f.read.median()) << '\n';
+         }
+      }
+   }
+   std::cout << "Sweep results written to: " << filename << "\n";
+}
@@ -0,0 +1,854 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#ifndef MSGPACK_NO_BOOST
+#define MSGPACK_NO_BOOST
+#endif
+#include "msgpack.hpp"
+
+#include "zpp_bits.h"
+
+#include "fields.hpp"
+
+// The payload types: the complex object (json0 in payloads.cpp) and its variants, the point clouds, the payload
+// families, and the pb:: structs that zpp_bits encodes as Protobuf
+
+// Structs for BEVE, MessagePack, CBOR
+struct fixed_object_t
+{
+   std::vector<int> int_array;
+   std::vector<float> float_array;
+   std::vector<double> double_array;
+
+   MSGPACK_DEFINE_MAP(int_array, float_array, double_array);
+};
+
+struct fixed_name_object_t
+{
+   std::string name0;
+   std::string name1;
+   std::string name2;
+   std::string name3;
+   std::string name4;
+
+   MSGPACK_DEFINE_MAP(name0, name1, name2, name3, name4);
+};
+
+struct nested_object_t
+{
+   std::vector<std::array<double, 3>> v3s;
+   std::string id;
+
+   MSGPACK_DEFINE_MAP(v3s, id);
+};
+
+struct another_object_t
+{
+   std::string string;
+   std::string another_string;
+   bool boolean;
+   nested_object_t nested_object;
+
+   MSGPACK_DEFINE_MAP(string, another_string, boolean, nested_object);
+};
+
+struct obj_t
+{
+   fixed_object_t fixed_object;
+   fixed_name_object_t fixed_name_object;
+   another_object_t another_object;
+   std::vector<std::string> string_array;
+   std::string string;
+   double number;
+   bool boolean;
+   bool another_bool;
+
+   MSGPACK_DEFINE_MAP(fixed_object, fixed_name_object, another_object, string_array, string, number, boolean,
+                      another_bool);
+};
+
+// Field tables for the hand-written protobuf codec (pb_direct.hpp). The field order, and so the field numbers,
+// matches the pb:: structs below, with std::array<double, 3> standing in for pb::vec3.
+template <>
+struct fields<fixed_object_t>
+{
+   using T = fixed_object_t;
+   static constexpr auto value = std::tuple{field{"int_array", &T::int_array}, field{"float_array", &T::float_array},
+                                            field{"double_array", &T::double_array}};
+};
+
+template <>
+struct fields<fixed_name_object_t>
+{
+   using T = fixed_name_object_t;
+   static constexpr auto value = std::tuple{field{"name0", &T::name0}, field{"name1", &T::name1},
+                                            field{"name2", &T::name2}, field{"name3", &T::name3},
+                                            field{"name4", &T::name4}};
+};
+
+template <>
+struct fields<nested_object_t>
+{
+   using T = nested_object_t;
+   static constexpr auto value = std::tuple{field{"v3s", &T::v3s}, field{"id", &T::id}};
+};
+
+template <>
+struct fields<another_object_t>
+{
+   using T = another_object_t;
+   static constexpr auto value = std::tuple{field{"string", &T::string}, field{"another_string", &T::another_string},
+                                            field{"boolean", &T::boolean}, field{"nested_object", &T::nested_object}};
+};
+
+template <>
+struct fields<obj_t>
+{
+   using T = obj_t;
+   static constexpr auto value =
+      std::tuple{field{"fixed_object", &T::fixed_object}, field{"fixed_name_object", &T::fixed_name_object},
+                 field{"another_object", &T::another_object}, field{"string_array", &T::string_array},
+                 field{"string", &T::string},           field{"number", &T::number},
+                 field{"boolean", &T::boolean},         field{"another_bool", &T::another_bool}};
+};
+
+// Point clouds for the layout benchmark: the same points as an array of structs (like nested_object_t::v3s) and as a
+// struct of arrays
+struct points_aos_t
+{
+   std::vector<std::array<double, 3>> points;
+
+   MSGPACK_DEFINE_MAP(points);
+};
+
+struct points_soa_t
+{
+   std::vector<double> x;
+   std::vector<double> y;
+   std::vector<double> z;
+
+   MSGPACK_DEFINE_MAP(x, y, z);
+};
+
+template <>
+struct fields<points_aos_t>
+{
+   static constexpr auto value = std::tuple{field{"points", &points_aos_t::points}};
+};
+
+template <>
+struct fields<points_soa_t>
+{
+   using T = points_soa_t;
+   static constexpr auto value = std::tuple{field{"x", &T::x}, field{"y", &T::y}, field{"z", &T::z}};
+};
+
+// The obj_t family on std::pmr containers for the arena benchmark. An object built by arena_obj() takes every string
+// and vector it decodes from one memory resource, so with a monotonic_buffer_resource that is released after each
+// message no read touches the heap. The field tables match the heap-backed structs, so the encodings are the same.
+namespace arena {
+
+struct fixed_object_t
+{
+   std::pmr::vector<int> int_array;
+   std::pmr::vector<float> float_array;
+   std::pmr::vector<double> double_array;
+
+   MSGPACK_DEFINE_MAP(int_array, float_array, double_array);
+};
+
+struct fixed_name_object_t
+{
+   std::pmr::string name0;
+   std::pmr::string name1;
+   std::pmr::string name2;
+   std::pmr::string name3;
+   std::pmr::string name4;
+
+   MSGPACK_DEFINE_MAP(name0, name1, name2, name3, name4);
+};
+
+struct nested_object_t
+{
+   std::pmr::vector<std::array<double, 3>> v3s;
+   std::pmr::string id;
+
+   MSGPACK_DEFINE_MAP(v3s, id);
+};
+
+struct another_object_t
+{
+   std::pmr::string string;
+   std::pmr::string another_string;
+   bool boolean;
+   nested_object_t nested_object;
+
+   MSGPACK_DEFINE_MAP(string, another_string, boolean, nested_object);
+};
+
+struct obj_t
+{
+   fixed_object_t fixed_object;
+   fixed_name_object_t fixed_name_object;
+   another_object_t another_object;
+   std::pmr::vector<std::pmr::string> string_array;
+   std::pmr::string string;
+   double number;
+   bool boolean;
+   bool another_bool;
+
+   MSGPACK_DEFINE_MAP(fixed_object, fixed_name_object, another_object, string_array, string, number, boolean,
+                      another_bool);
+};
+
+} // namespace arena
+
+template <>
+struct fields<arena::fixed_object_t>
+{
+   using T = arena::fixed_object_t;
+   static constexpr auto value = std::tuple{field{"int_array", &T::int_array}, field{"float_array", &T::float_array},
+                                            field{"double_array", &T::double_array}};
+};
+
+template <>
+struct fields<arena::fixed_name_object_t>
+{
+   using T = arena::fixed_name_object_t;
+   static constexpr auto value = std::tuple{field{"name0", &T::name0}, field{"name1", &T::name1},
+                                            field{"name2", &T::name2}, field{"name3", &T::name3},
+                                            field{"name4", &T::name4}};
+};
+
+template <>
+struct fields<arena::nested_object_t>
+{
+   using T = arena::nested_object_t;
+   static constexpr auto value = std::tuple{field{"v3s", &T::v3s}, field{"id", &T::id}};
+};
+
+template <>
+struct fields<arena::another_object_t>
+{
+   using T = arena::another_object_t;
+   static constexpr auto value = std::tuple{field{"string", &T::string}, field{"another_string", &T::another_string},
+                                            field{"boolean", &T::boolean}, field{"nested_object", &T::nested_object}};
+};
+
+template <>
+struct fields<arena::obj_t>
+{
+   using T = arena::obj_t;
+   static constexpr auto value =
+      std::tuple{field{"fixed_object", &T::fixed_object}, field{"fixed_name_object", &T::fixed_name_object},
+                 field{"another_object", &T::another_object}, field{"string_array", &T::string_array},
+                 field{"string", &T::string},           field{"number", &T::number},
+                 field{"boolean", &T::boolean},         field{"another_bool", &T::another_bool}};
+};
+
+// Payload families beyond numbers and the json0 object: log lines (std::vector<std::string>), metric bags
+// (std::map and std::unordered_map<std::string, double>), event unions and records where most fields are absent
+
+struct login_event_t
+{
+   std::string user;
+   uint64_t timestamp;
+   bool success;
+
+   MSGPACK_DEFINE_MAP(user, timestamp, success);
+};
+
+struct metric_event_t
+{
+   std::string name;
+   double value;
+   uint64_t timestamp;
+
+   MSGPACK_DEFINE_MAP(name, value, timestamp);
+};
+
+struct error_event_t
+{
+   int32_t code;
+   std::string message;
+   std::vector<std::string> stack;
+
+   MSGPACK_DEFINE_MAP(code, message, stack);
+};
+
+// Every alternative starts with a key of its own, which is what Glaze JSON deduces the alternative from
+using event_t = std::variant<login_event_t, metric_event_t, error_event_t>;
+
+struct sparse_record_t
+{
+   uint64_t id;
+   std::optional<double> temperature;
+   std::optional<double> pressure;
+   std::optional<double> humidity;
+   std::optional<double> wind_speed;
+   std::optional<int64_t> error_count;
+   std::optional<int64_t> retry_count;
+   std::optional<uint32_t> status;
+   std::optional<std::string> host;
+   std::optional<std::string> region;
+   std::optional<std::string> note;
+
+   MSGPACK_DEFINE_MAP(id, temperature, pressure, humidity, wind_speed, error_count, retry_count, status, host, region,
+                      note);
+};
+
+// msgpack-c only adapts std::string; std::pmr::string is packed and converted the same way. It has no adaptor for
+// std::variant.
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+
+template <>
+struct convert<std::pmr::string>
+{
+   const msgpack::object& operator()(const msgpack::object& o, std::pmr::string& v) const
+   {
+      if (o.type == msgpack::type::STR) {
+         v.assign(o.via.str.ptr, o.via.str.size);
+      }
+      else if (o.type == msgpack::type::BIN) {
+         v.assign(o.via.bin.ptr, o.via.bin.size);
+      }
+      else {
+         throw msgpack::type_error();
+      }
+      return o;
+   }
+};
+
+template <>
+struct pack<std::pmr::string>
+{
+   template <class Stream>
+   msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const std::pmr::string& v) const
+   {
+      const auto size = checked_get_container_size(v.size());
+      o.pack_str(size);
+      o.pack_str_body(v.data(), size);
+      return o;
+   }
+};
+
+// event_t as a two element array: the index of the alternative, then the alternative
+template <>
+struct convert<event_t>
+{
+   template <size_t I>
+   static void assign(const msgpack::object& o, event_t& v)
+   {
+      if (v.index() != I) {
+         v.emplace<I>();
+      }
+      o.convert(std::get<I>(v));
+   }
+
+   const msgpack::object& operator()(const msgpack::object& o, event_t& v) const
+   {
+      if (o.type != msgpack::type::ARRAY || o.via.array.size != 2) {
+         throw msgpack::type_error();
+      }
+      const auto& alternative = o.via.array.ptr[1];
+      switch (o.via.array.ptr[0].as<uint32_t>()) {
+      case 0:
+         assign<0>(alternative, v);
+         break;
+      case 1:
+         assign<1>(alternative, v);
+         break;
+      case 2:
+         assign<2>(alternative, v);
+         break;
+      default:
+         throw msgpack::type_error();
+      }
+      return o;
+   }
+};
+
+template <>
+struct pack<event_t>
+{
+   template <class Stream>
+   msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const event_t& v) const
+   {
+      o.pack_array(2);
+      o.pack(uint32_t(v.index()));
+      std::visit([&](const auto& alternative) { o.pack(alternative); }, v);
+      return o;
+   }
+};
+
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
+
+// Writers on other versions of the obj_t schema, for the schema evolution benchmark. The field tables keep the
+// protobuf field numbers of obj_t, so every format sees the same change: fields the reader does not know, fields
+// it expects but that are not there, or its fields in a different order.
+
+// A newer schema: obj_t followed by fields of several types that an obj_t reader must skip
+struct obj_unknown_t
+{
+   fixed_object_t fixed_object;
+   fixed_name_object_t fixed_name_object;
+   another_object_t another_object;
+   std::vector<std::string> string_array;
+   std::string string;
+   double number;
+   bool boolean;
+   bool another_bool;
+   int64_t extra_integer;
+   double extra_number;
+   std::string extra_string;
+   std::vector<double> extra_numbers;
+   std::vector<std::string> extra_strings;
+   std::vector<nested_object_t> extra_objects;
+
+   MSGPACK_DEFINE_MAP(fixed_object, fixed_name_object, another_object, string_array, string, number, boolean,
+                      another_bool, extra_integer, extra_number, extra_string, extra_numbers, extra_strings,
+                      extra_objects);
+};
+
+// An older schema without another_object, string_array and another_bool
+struct obj_missing_t
+{
+   fixed_object_t fixed_object;
+   fixed_name_object_t fixed_name_object;
+   std::string string;
+   double number;
+   bool boolean;
+
+   MSGPACK_DEFINE_MAP(fixed_object, fixed_name_object, string, number, boolean);
+};
+
+// The obj_t fields in another order
+struct obj_reordered_t
+{
+   bool another_bool;
+   double number;
+   std::vector<std::string> string_array;
+   another_object_t another_object;
+   std::string string;
+   bool boolean;
+   fixed_name_object_t fixed_name_object;
+   fixed_object_t fixed_object;
+
+   MSGPACK_DEFINE_MAP(another_bool, number, string_array, another_object, string, boolean, fixed_name_object,
+                      fixed_object);
+};
+
+template <>
+struct fields<obj_unknown_t>
+{
+   using T = obj_unknown_t;
+   static constexpr auto value =
+      std::tuple{field{"fixed_object", &T::fixed_object}, field{"fixed_name_object", &T::fixed_name_object},
+                 field{"another_object", &T::another_object}, field{"string_array", &T::string_array},
+                 field{"string", &T::string},           field{"number", &T::number},
+                 field{"boolean", &T::boolean},         field{"another_bool", &T::another_bool},
+                 field{"extra_integer", &T::extra_integer}, field{"extra_number", &T::extra_number},
+                 field{"extra_string", &T::extra_string}, field{"extra_numbers", &T::extra_numbers},
+                 field{"extra_strings", &T::extra_strings}, field{"extra_objects", &T::extra_objects}};
+};
+
+template <>
+struct fields<obj_missing_t>
+{
+   using T = obj_missing_t;
+   static constexpr auto value =
+      std::tuple{field{"fixed_object", &T::fixed_object, 1}, field{"fixed_name_object", &T::fixed_name_object, 2},
+                 field{"string", &T::string, 5}, field{"number", &T::number, 6}, field{"boolean", &T::boolean, 7}};
+};
+
+template <>
+struct fields<obj_reordered_t>
+{
+   using T = obj_reordered_t;
+   static constexpr auto value =
+      std::tuple{field{"another_bool", &T::another_bool, 8}, field{"number", &T::number, 6},
+                 field{"string_array", &T::string_array, 4}, field{"another_object", &T::another_object, 3},
+                 field{"string", &T::string, 5}, field{"boolean", &T::boolean, 7},
+                 field{"fixed_name_object", &T::fixed_name_object, 2}, field{"fixed_object", &T::fixed_object, 1}};
+};
+
+// Protobuf-compatible structs for zpp_bits
+namespace pb {
+
+struct fixed_object_t
+{
+   std::vector<zpp::bits::vsint32_t> int_array;  // signed varint
+   std::vector<float> float_array;               // fixed32
+   std::vector<double> double_array;             // fixed64
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct fixed_name_object_t
+{
+   std::string name0;
+   std::string name1;
+   std::string name2;
+   std::string name3;
+   std::string name4;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct vec3 {
+   double x, y, z;
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct nested_object_t
+{
+   std::vector<vec3> v3s;
+   std::string id;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct another_object_t
+{
+   std::string string;
+   std::string another_string;
+   bool boolean;
+   nested_object_t nested_object;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct obj_t
+{
+   fixed_object_t fixed_object;
+   fixed_name_object_t fixed_name_object;
+   another_object_t another_object;
+   std::vector<std::string> string_array;
+   std::string string;
+   double number;
+   bool boolean;
+   bool another_bool;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// repeated vec3 points = 1
+struct points_aos_t
+{
+   std::vector<vec3> points;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// Three packed repeated doubles
+struct points_soa_t
+{
+   std::vector<double> x;
+   std::vector<double> y;
+   std::vector<double> z;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// A batch of objects as one message (repeated obj_t objs = 1)
+struct batch_t
+{
+   std::vector<obj_t> objs;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// Convert from regular structs to protobuf structs
+inline fixed_object_t to_pb(const ::fixed_object_t& src) {
+   fixed_object_t dst;
+   dst.int_array.reserve(src.int_array.size());
+   for (auto v : src.int_array) dst.int_array.push_back(zpp::bits::vsint32_t{v});
+   dst.float_array = src.float_array;
+   dst.double_array = src.double_array;
+   return dst;
+}
+
+inline fixed_name_object_t to_pb(const ::fixed_name_object_t& src) {
+   return {src.name0, src.name1, src.name2, src.name3, src.name4};
+}
+
+inline nested_object_t to_pb(const ::nested_object_t& src) {
+   nested_object_t dst;
+   dst.v3s.reserve(src.v3s.size());
+   for (const auto& arr : src.v3s) {
+      dst.v3s.push_back({arr[0], arr[1], arr[2]});
+   }
+   dst.id = src.id;
+   return dst;
+}
+
+inline another_object_t to_pb(const ::another_object_t& src) {
+   return {src.string, src.another_string, src.boolean, to_pb(src.nested_object)};
+}
+
+inline obj_t to_pb(const ::obj_t& src) {
+   return {to_pb(src.fixed_object), to_pb(src.fixed_name_object), to_pb(src.another_object),
+           src.string_array, src.string, src.number, src.boolean, src.another_bool};
+}
+
+// Convert from protobuf structs back to regular structs
+inline ::fixed_object_t from_pb(const fixed_object_t& src) {
+   ::fixed_object_t dst;
+   dst.int_array.reserve(src.int_array.size());
+   for (auto v : src.int_array) dst.int_array.push_back(static_cast<int>(v));
+   dst.float_array = src.float_array;
+   dst.double_array = src.double_array;
+   return dst;
+}
+
+inline ::fixed_name_object_t from_pb(const fixed_name_object_t& src) {
+   return {src.name0, src.name1, src.name2, src.name3, src.name4};
+}
+
+inline ::nested_object_t from_pb(const nested_object_t& src) {
+   ::nested_object_t dst;
+   dst.v3s.reserve(src.v3s.size());
+   for (const auto& v : src.v3s) {
+      dst.v3s.push_back({v.x, v.y, v.z});
+   }
+   dst.id = src.id;
+   return dst;
+}
+
+inline ::another_object_t from_pb(const another_object_t& src) {
+   return {src.string, src.another_string, src.boolean, from_pb(src.nested_object)};
+}
+
+inline ::obj_t from_pb(const obj_t& src) {
+   return {from_pb(src.fixed_object), from_pb(src.fixed_name_object), from_pb(src.another_object),
+           src.string_array, src.string, src.number, src.boolean, src.another_bool};
+}
+
+inline points_aos_t to_pb(const ::points_aos_t& src) {
+   points_aos_t dst;
+   dst.points.reserve(src.points.size());
+   for (const auto& p : src.points) dst.points.push_back({p[0], p[1], p[2]});
+   return dst;
+}
+
+inline ::points_aos_t from_pb(const points_aos_t& src) {
+   ::points_aos_t dst;
+   dst.points.reserve(src.points.size());
+   for (const auto& p : src.points) dst.points.push_back({p.x, p.y, p.z});
+   return dst;
+}
+
+inline points_soa_t to_pb(const ::points_soa_t& src) { return {src.x, src.y, src.z}; }
+inline ::points_soa_t from_pb(const points_soa_t& src) { return {src.x, src.y, src.z}; }
+
+inline batch_t to_pb(const std::vector<::obj_t>& src) {
+   batch_t dst;
+   dst.objs.reserve(src.size());
+   for (const auto& obj : src) dst.objs.push_back(to_pb(obj));
+   return dst;
+}
+
+inline std::vector<::obj_t> from_pb(const batch_t& src) {
+   std::vector<::obj_t> dst;
+   dst.reserve(src.objs.size());
+   for (const auto& obj : src.objs) dst.push_back(from_pb(obj));
+   return dst;
+}
+
+// Log lines: repeated string values = 1
+struct strings_t
+{
+   std::vector<std::string> values;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// map<string, double> values = 1
+struct metrics_t
+{
+   std::map<std::string, double> values;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct unordered_metrics_t
+{
+   std::unordered_map<std::string, double> values;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct login_event_t
+{
+   std::string user;
+   zpp::bits::vuint64_t timestamp;
+   bool success;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct metric_event_t
+{
+   std::string name;
+   double value;
+   zpp::bits::vuint64_t timestamp;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct error_event_t
+{
+   zpp::bits::vsint32_t code;
+   std::string message;
+   std::vector<std::string> stack;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// A oneof spelled out: kind is the index of the alternative and only that message is filled in
+struct event_t
+{
+   zpp::bits::vuint32_t kind;
+   login_event_t login;
+   metric_event_t metric;
+   error_event_t error;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct events_t
+{
+   std::vector<event_t> events;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+// proto3 fields without explicit presence: an absent value is a zero that is not written. random_sparse_records()
+// never sets a present field to zero or an empty string, so presence survives the round trip.
+struct sparse_record_t
+{
+   zpp::bits::vuint64_t id;
+   double temperature;
+   double pressure;
+   double humidity;
+   double wind_speed;
+   zpp::bits::vsint64_t error_count;
+   zpp::bits::vsint64_t retry_count;
+   zpp::bits::vuint32_t status;
+   std::string host;
+   std::string region;
+   std::string note;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+struct sparse_records_t
+{
+   std::vector<sparse_record_t> records;
+
+   using serialize = zpp::bits::pb_protocol;
+};
+
+inline strings_t to_pb(const std::vector<std::string>& src) { return {src}; }
+inline std::vector<std::string> from_pb(const strings_t& src) { return src.values; }
+
+inline metrics_t to_pb(const std::map<std::string, double>& src) { return {src}; }
+inline std::map<std::string, double> from_pb(const metrics_t& src) { return src.values; }
+
+inline unordered_metrics_t to_pb(const std::unordered_map<std::string, double>& src) { return {src}; }
+inline std::unordered_map<std::string, double> from_pb(const unordered_metrics_t& src) { return src.values; }
+
+inline events_t to_pb(const std::vector<::event_t>& src) {
+   events_t dst;
+   dst.events.resize(src.size());
+   for (size_t i = 0; i < src.size(); ++i) {
+      auto& e = dst.events[i];
+      e.kind = uint32_t(src[i].index());
+      if (const auto* login = std::get_if<::login_event_t>(&src[i])) {
+         e.login = {login->user, login->timestamp, login->success};
+      }
+      else if (const auto* metric = std::get_if<::metric_event_t>(&src[i])) {
+         e.metric = {metric->name, metric->value, metric->timestamp};
+      }
+      else if (const auto* error = std::get_if<::error_event_t>(&src[i])) {
+         e.error = {error->code, error->message, error->stack};
+      }
+   }
+   return dst;
+}
+
+inline std::vector<::event_t> from_pb(const events_t& src) {
+   std::vector<::event_t> dst;
+   dst.reserve(src.events.size());
+   for (const auto& e : src.events) {
+      switch (uint32_t(e.kind)) {
+      case 1:
+         dst.push_back(::metric_event_t{e.metric.name, e.metric.value, e.metric.timestamp});
+         break;
+      case 2:
+         dst.push_back(::error_event_t{e.error.code, e.error.message, e.error.stack});
+         break;
+      default:
+         dst.push_back(::login_event_t{e.login.user, e.login.timestamp, e.login.success});
+         break;
+      }
+   }
+   return dst;
+}
+
+inline sparse_records_t to_pb(const std::vector<::sparse_record_t>& src) {
+   sparse_records_t dst;
+   dst.records.resize(src.size());
+   for (size_t i = 0; i < src.size(); ++i) {
+      const auto& r = src[i];
+      dst.records[i] = {r.id,
+                        r.temperature.value_or(0.0),
+                        r.pressure.value_or(0.0),
+                        r.humidity.value_or(0.0),
+                        r.wind_speed.value_or(0.0),
+                        r.error_count.value_or(0),
+                        r.retry_count.value_or(0),
+                        r.status.value_or(0),
+                        r.host.value_or(""),
+                        r.region.value_or(""),
+                        r.note.value_or("")};
+   }
+   return dst;
+}
+
+inline std::vector<::sparse_record_t> from_pb(const sparse_records_t& src) {
+   const auto present = [](auto v) { return v ? std::optional{v} : std::nullopt; };
+   const auto text = [](const std::string& v) { return v.empty() ? std::nullopt : std::optional{v}; };
+   std::vector<::sparse_record_t> dst(src.records.size());
+   for (size_t i = 0; i < dst.size(); ++i) {
+      const auto& r = src.records[i];
+      dst[i] = {r.id,
+                present(r.temperature),
+                present(r.pressure),
+                present(r.humidity),
+                present(r.wind_speed),
+                present(int64_t(r.error_count)),
+                present(int64_t(r.retry_count)),
+                present(uint32_t(r.status)),
+                text(r.host),
+                text(r.region),
+                text(r.note)};
+   }
+   return dst;
+}
+
+} // namespace pb
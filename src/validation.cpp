@@ -0,0 +1,138 @@
+// Validate-only mode: each format checked for well-formedness without decoding into a C++ value, as a gateway that
+// validates and forwards would, next to a full decode of the same message
+
+#include <iostream>
+
+#include "beve_reader.hpp"
+#include "cbor_reader.hpp"
+#include "pb_wire.hpp"
+#include "roofline.hpp"
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+struct json_validator
+{
+   using codec = json_codec;
+   static constexpr std::string_view method = "`glz::validate_json`";
+   static bool validate(const std::string& in) { return !glz::validate_json(in); }
+};
+
+struct beve_validator
+{
+   using codec = beve_codec;
+   static constexpr std::string_view method = "structural walk (`beve_reader.hpp`)";
+   static bool validate(const std::string& in) { return beve::validate(in); }
+};
+
+struct msgpack_validator
+{
+   using codec = msgpack_codec;
+   static constexpr std::string_view method = "`msgpack::parse` with a `null_visitor`, no object tree or `convert`";
+
+   static bool validate(const std::string& in)
+   {
+      msgpack::null_visitor visitor{};
+      size_t offset = 0;
+      return msgpack::parse(in.data(), in.size(), offset, visitor) && offset == in.size();
+   }
+};
+
+struct cbor_validator
+{
+   using codec = cbor_codec;
+   static constexpr std::string_view method = "structural walk (`cbor_reader.hpp`)";
+   static bool validate(const std::string& in) { return cbor::validate(in); }
+};
+
+struct protobuf_validator
+{
+   using codec = protobuf_codec;
+   static constexpr std::string_view method = "top-level tag/length walk (`pb_wire.hpp`)";
+   static bool validate(const std::string& in) { return pb_wire::validate(in); }
+};
+
+using validators =
+   std::tuple<json_validator, beve_validator, msgpack_validator, cbor_validator, protobuf_validator>;
+
+template <class Validator, class T>
+validation_point run_validation(const T& value)
+{
+   using C = typename Validator::codec;
+   validation_point p{};
+   std::string buffer{};
+   C::encode(value, buffer);
+   p.size = buffer.size();
+   T dst{};
+   p.ok = Validator::validate(buffer) && C::decode(buffer, dst);
+   if (!p.ok) {
+      std::cerr << C::name << " validation error!\n";
+      return p;
+   }
+   p.validate = measure_for([&] {
+      auto valid = Validator::validate(buffer);
+      roofline::clobber(&valid); // the walkers have no side effects to keep them from being optimized away
+   });
+   p.decode = measure_for([&] { C::decode(buffer, dst); });
+   return p;
+}
+
+template <class T>
+validation_result validation_payload(std::string name, const T& value)
+{
+   std::cout << "  " << name << "\n";
+   validation_result r{std::move(name)};
+   std::apply(
+      [&](auto... v) {
+         ((r.formats[format_index<typename decltype(v)::codec>] = run_validation<decltype(v)>(value)), ...);
+      },
+      validators{});
+   return r;
+}
+
+} // namespace
+
+// The complex object and the vector payloads of the fixed tests
+std::vector<validation_result> validation_test()
+{
+   std::vector<validation_result> results;
+   results.push_back(validation_payload("Complex Nested Object", make_obj()));
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      results.push_back(validation_payload("std::vector<" + std::string(type) + "> (10K)", random_vector<T>()));
+   });
+   return results;
+}
+
+void write_validation_section(std::ostream& out, const report& rep)
+{
+   const auto& validation = rep.validation;
+   if (validation.empty()) {
+      return;
+   }
+
+   out << "\n## Validate-Only Parsing\n\n";
+   out << "Each message checked for well-formedness without decoding it into a C++ value, as a gateway that validates ";
+   out << "and forwards would. Each cell is validation throughput, then how many times faster than a full decode ";
+   out << "(Read, into a reused destination) of the same message it is. Each phase is timed for "
+       << measure_defaults.target_seconds << " s. Methods:\n\n";
+   std::apply(
+      [&](auto... v) { ((out << "- " << decltype(v)::codec::name << ": " << decltype(v)::method << "\n"), ...); },
+      validators{});
+   out << "\nThe BEVE, CBOR and MessagePack checks cover the whole structure; the Protobuf walk cannot tell nested ";
+   out << "messages from strings without a schema, so it only checks the top-level fields.\n\n";
+
+   write_format_header(out, {"Payload"});
+   for (const auto& r : validation) {
+      write_format_row(out, r.name, [&](size_t f) {
+         const auto& p = r.formats[f];
+         if (!p.ok) {
+            return std::string("error");
+         }
+         return format_throughput(p.size, p.validate.median()) + " (" + format_speedup(p.decode, p.validate) + ")";
+      });
+   }
+}
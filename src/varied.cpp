@@ -0,0 +1,97 @@
+// Varied-payload mode: every iteration encodes or decodes the next of N distinct, schema-identical messages instead
+// of the same one, so branch predictors cannot learn a single message. N is kept small enough for the pool to stay
+// cache resident, which leaves branch behaviour as the main difference to the fixed-message runs.
+
+#include <iostream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+// Vectors of the same length with a different seed each. A 10K element vector is already far longer than any branch
+// history, so a few of them are enough and keep the pool of large JSON buffers small.
+constexpr size_t varied_vector_payloads = 4;
+
+template <class Codec, class T>
+results run_varied(const std::vector<T>& payloads)
+{
+   using bench = codec_bench<Codec, T>;
+   std::vector<bench> benches;
+   benches.reserve(payloads.size());
+   for (const auto& payload : payloads) {
+      benches.emplace_back(payload);
+   }
+   bench_pool<bench> pool{std::move(benches), false};
+   return run_bench(pool, Codec::name);
+}
+
+template <class T>
+varied_result varied_payload(std::string name, const std::vector<T>& payloads)
+{
+   std::cout << "  " << name << "\n";
+   return {std::move(name), map_formats([&](auto c) { return run_varied<decltype(c)>(payloads); })};
+}
+
+} // namespace
+
+std::vector<varied_result> varied_test(size_t payloads)
+{
+   std::vector<varied_result> results;
+   results.push_back(varied_payload("Complex Nested Object", random_objs(payloads)));
+   for_each_vector_type([&]<class T>(std::type_identity<T>, std::string_view type) {
+      std::vector<std::vector<T>> vectors(varied_vector_payloads);
+      for (size_t i = 0; i < vectors.size(); ++i) {
+         vectors[i] = random_vector<T>(vector_size, i + 1);
+      }
+      results.push_back(varied_payload("std::vector<" + std::string(type) + "> (10K)", vectors));
+   });
+   return results;
+}
+
+void write_varied_section(std::ostream& out, const report& rep)
+{
+   if (rep.varied.empty()) {
+      return;
+   }
+
+   out << "\n## Varied vs Fixed Payloads\n\n";
+   out << "Fixed runs encode and decode one message over and over, which lets the branch predictor learn every ";
+   out << "data-dependent branch of that message. Varied runs cycle through " << rep.varied_payloads
+       << " distinct messages with the same schema: for the complex object, string and array lengths, integer bit ";
+   out << "widths, floating-point magnitudes and booleans are drawn at random; vector tests cycle through "
+       << varied_vector_payloads << " vectors with a different seed each. ";
+   out << "Sizes are the mean message size. Slowdown compares throughput (bytes/s), since the varied messages differ ";
+   out << "in size from the fixed one.\n";
+
+   for (const auto& v : rep.varied) {
+      const auto fixed = std::find_if(rep.results.begin(), rep.results.end(),
+                                      [&](const benchmark_result& r) { return r.name == v.name; });
+      if (fixed == rep.results.end()) {
+         continue;
+      }
+
+      out << "\n### " << v.name << "\n\n";
+      write_format_header(out, {"Metric"});
+      write_format_row(out, "Fixed Size", [&](size_t f) { return format_size(fixed->formats[f].size); });
+      write_format_row(out, "Varied Mean Size", [&](size_t f) { return format_size(v.formats[f].size); });
+      for (auto phase : {&results::write, &results::read}) {
+         const std::string label = phase == &results::write ? "Write" : "Read";
+         write_format_row(out, "Fixed " + label, [&](size_t f) {
+            const auto& r = fixed->formats[f];
+            return format_throughput(r.size, r.*phase);
+         });
+         write_format_row(out, "Varied " + label, [&](size_t f) {
+            const auto& r = v.formats[f];
+            return format_throughput(r.size, r.*phase);
+         });
+         write_format_row(out, label + " Slowdown", [&](size_t f) {
+            const auto& a = fixed->formats[f];
+            const auto& b = v.formats[f];
+            return format_speedup(double(a.size) / (a.*phase).median(), double(b.size) / (b.*phase).median());
+         });
+      }
+   }
+}
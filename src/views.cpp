@@ -0,0 +1,120 @@
+// Zero-copy view reads over the buffer written by each format's codec, see views.hpp. CBOR is left out because Glaze
+// has no view-based CBOR reader.
+
+#include <iostream>
+
+#include "format.hpp"
+#include "payloads.hpp"
+#include "report.hpp"
+
+namespace
+{
+
+struct json_view_bench
+{
+   using codec = json_codec;
+
+   codec_bench<codec, obj_t> source{make_obj()};
+   obj_view_t<glz::raw_json_view> view{};
+
+   bool read() { return !glz::read_json(view, source.buffer); }
+};
+
+struct beve_view_bench
+{
+   using codec = beve_codec;
+
+   codec_bench<codec, obj_t> source{make_obj()};
+   obj_view_t<beve::raw_value> view{};
+
+   bool read()
+   {
+      beve::cursor c{source.buffer};
+      beve::read_view(c, view);
+      return c.ok;
+   }
+};
+
+// msgpack-c object tree without convert(): strings and arrays reference the buffer and the zone
+struct msgpack_view_bench
+{
+   using codec = msgpack_codec;
+
+   codec_bench<codec, obj_t> source{make_obj()};
+   msgpack::object_handle oh{};
+   obj_view_t<msgpack_view::array> view{};
+
+   bool read()
+   {
+      oh = msgpack::unpack(source.buffer.data(), source.buffer.size(), msgpack_view::reference_all);
+      return msgpack_view::read_view(oh.get(), view);
+   }
+};
+
+struct protobuf_view_bench
+{
+   using codec = protobuf_codec;
+
+   codec_bench<codec, obj_t> source{make_obj()};
+   obj_view_t<pb_wire::raw_field> view{};
+
+   bool read()
+   {
+      pb_wire::cursor c{source.buffer.data(), source.buffer.size()};
+      pb_wire::read_message(c, view);
+      return c.ok;
+   }
+};
+
+template <class Bench>
+void run_view(view_result& r)
+{
+   Bench bench{};
+   if (!bench.read()) {
+      std::cerr << Bench::codec::name << " view error!\n";
+      return;
+   }
+   r[format_index<typename Bench::codec>] = measure_for([&] { bench.read(); });
+}
+
+} // namespace
+
+view_result view_test()
+{
+   view_result r{};
+   run_view<json_view_bench>(r);
+   run_view<beve_view_bench>(r);
+   run_view<msgpack_view_bench>(r);
+   run_view<protobuf_view_bench>(r);
+   return r;
+}
+
+void write_view_section(std::ostream& out, const report& rep)
+{
+   if (!rep.views || rep.results.empty()) {
+      return;
+   }
+   const auto& full = rep.results.front(); // Complex Nested Object
+   const auto& v = *rep.views;
+
+   out << "\n## Zero-Copy View Reads\n\n";
+   out << "View reads decode the " << full.name << " into a mirror of `obj_t` whose strings are `std::string_view` ";
+   out << "into the serialized buffer and whose arrays stay in wire form: raw JSON text (`glz::raw_json_view`), ";
+   out << "encoded BEVE values, the msgpack-c object array (`msgpack::unpack` without `convert`, strings referenced), ";
+   out << "and protobuf field payloads. ";
+   out << "The gap to Read shows how much of the full decode is copying and materializing rather than parsing.\n\n";
+
+   const auto view_cell = [&](size_t f, auto&& cell) { return v[f] ? cell(full.formats[f], *v[f]) : "n/a"; };
+   write_format_header(out, {"Metric"});
+   write_format_row(out, "Read Throughput",
+                    [&](size_t f) { return format_throughput(full.formats[f].size, full.formats[f].read.median()); });
+   write_format_row(out, "View Read Throughput", [&](size_t f) {
+      return view_cell(f, [](const results& r, const measurement& m) { return format_throughput(r.size, m.median()); });
+   });
+   write_format_row(out, "View Speedup", [&](size_t f) {
+      return view_cell(f, [](const results& r, const measurement& m) { return format_speedup(r.read, m); });
+   });
+   write_format_row(out, "View Read Allocations", [&](size_t f) {
+      return view_cell(f, [](const results&, const measurement& m) { return format_allocs(m); });
+   });
+}